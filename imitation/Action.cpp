@@ -3,7 +3,7 @@
 Action::Action(void) {}
 
 Action::Action(int numVal, string nameVal, State preCondsVal, State postCondsVal, double costVal)
-: num(numVal), name(nameVal), preConds(preCondsVal), postConds(postCondsVal), cost(costVal) {}
+: num(numVal), name(move(nameVal)), preConds(move(preCondsVal)), postConds(move(postCondsVal)), cost(costVal) {}
 
 Action::~Action(void) {}
 
@@ -14,7 +14,7 @@ Action::~Action(void) {}
 			  p2, parameter 2
 	Return	: Action
 */
-void Action::parameterize(string p1, string p2)
+void Action::parameterize(Symbol p1, Symbol p2)
 {
 	// parameterize pre-condition
 	parameterize(preConds, p1, p2);
@@ -36,23 +36,28 @@ void Action::parameterize(string p1, string p2)
 			  p2, parameter 2
 	Return	: State
 */
-void Action::parameterize(State& state, string p1, string p2)
+void Action::parameterize(State& state, Symbol p1, Symbol p2)
 {
 	int i;
+	Relation r;
 	
 	for (i=0; i<state.size(); ++i)
 	{
-		if (state[i].objA=="PARA_1") {
-			state[i].objA=p1;
-		} else if (state[i].objA=="PARA_2") {
-			state[i].objA=p2;
+		r = state[i];
+
+		if (r.objA==SYM_PARA_1) {
+			r.objA=p1;
+		} else if (r.objA==SYM_PARA_2) {
+			r.objA=p2;
 		}
 			
-		if (state[i].objB=="PARA_1") {
-			state[i].objB=p1;
-		} else if (state[i].objB=="PARA_2") {
-			state[i].objB=p2;
+		if (r.objB==SYM_PARA_1) {
+			r.objB=p1;
+		} else if (r.objB==SYM_PARA_2) {
+			r.objB=p2;
 		}
+
+		state.replace(i, r);
 	}
 }
 
@@ -62,14 +67,17 @@ void Action::parameterize(State& state, string p1, string p2)
 	Para.	: currState, current state
 	Return	: next state after executing this instance
 	Note	: need call ParameterizeAction and IsSatisfied() first.
+			  The preconditions are removed, the effects applied in the order of actions.txt and the
+			  postconditions added
 */
-State Action::Execute(const State& currState)
+State Action::Execute(const State& currState) const
 {
+	size_t k;
 	int i;
+	Symbol object;
 	State nextState;
 
-	vector<string>::iterator p;
-	vector<Relation>::iterator q;
+	State::const_iterator p;
 
 	//update next state when action's preconditon is satisfied
 	nextState = currState;
@@ -77,75 +85,59 @@ State Action::Execute(const State& currState)
 	// remove precond from next state
 	nextState.remove(preConds);
 	
-	// check current action's number
-	switch (num) {
-		case 0:		// MOVE
-		case 3:		// PUSH
-			// for MOVE/PUSH action, change other "NEXT" to "AWAY" which are not included in preConds
-			for (i=0;i<nextState.size();++i)
-				if (nextState[i].relation=="NEXT")
-					nextState[i].relation="AWAY";	// hardcode here, change later
-
-			// if other objects are next to the target object, update the relation between those objects and imitator
-			if (find(nextState.nextTo.begin(), nextState.nextTo.end(), paras[0])!=nextState.nextTo.end())
-			{
-				for (i=0; i<nextState.nextTo.size(); ++i)
+	for (k=0; k<effects.size(); ++k)
+	{
+		object = paras[effects[k].para];
+
+		switch (effects[k].type) {
+			case AWAY_OTHERS:
+				// change other "NEXT" to "AWAY" which are not included in preConds
+				for (i=0;i<nextState.size();++i)
+					if (nextState[i].relation==SYM_NEXT)
+						nextState.replace(i, Relation(SYM_AWAY, nextState[i].objA, nextState[i].objB));
+				break;
+			case CARRY:
+				// if other objects are next to the object, update the relation between those objects and imitator
+				if (nextState.nextTo.contains(object))
 				{
-					q = find(nextState.begin(), nextState.end(), Relation("AWAY", "Imitator", nextState.nextTo[i]));
-					if (q!=nextState.end())
-						q->relation = "NEXT";
+					for (i=nextState.nextTo.next(-1); i!=-1; i=nextState.nextTo.next(i))
+					{
+						p = find(nextState.begin(), nextState.end(), Relation(SYM_AWAY, SYM_IMITATOR, Symbol::at(i)));
+						if (p!=nextState.end())
+							nextState.replace(p-nextState.begin(), Relation(SYM_NEXT, p->objA, p->objB));
+					}
 				}
-			}
-
-			// for PUSH action
-			if (num==3)
-			{
-				// push away
-				p= find(nextState.nextTo.begin(), nextState.nextTo.end(), paras[1]);
-				if (p!=nextState.nextTo.end())
-					nextState.nextTo.erase(p);
-				
+				break;
+			case LEAVE:
+				// a single object left isn't next to anything
+				nextState.nextTo.remove(object);
 				if (nextState.nextTo.size()<2)
 					nextState.nextTo.clear();
-
-				// push toward
-				nextState.nextTo.push_back(paras[1]);
-				p= find(nextState.nextTo.begin(), nextState.nextTo.end(), paras[0]);
-				if (p!=nextState.nextTo.end())
-					nextState.nextTo.push_back(paras[0]);
-			}
-			break;
-		case 1:		// GRAB
-			// check whether the object grabed is next to other object before
-			p= find(nextState.nextTo.begin(), nextState.nextTo.end(), paras[0]);
-			if (p!=nextState.nextTo.end())
-				nextState.nextTo.erase(p);
-			
-			if (nextState.nextTo.size()<2)
-				nextState.nextTo.clear();
-
-			break;
-		case 2:		// DROP
-			Relation r("NEXT", "Imitator", "?");
-			vector<Relation>::iterator p = find(nextState.begin(), nextState.end(), r);
-			if (p!=nextState.end())
-			{
-				if (nextState.nextTo.size() == 0)
-					nextState.nextTo.push_back(p->objB);
-
+				break;
+			case JOIN:
+				nextState.nextTo.add(object);
+				break;
+			case REPEAT:
+				if (nextState.nextTo.contains(object))
+					nextState.nextTo.add(object);
+				break;
+			case GROUP:
 				// If there is something next to the imitator, add this object to nextTo
-				nextState.nextTo.push_back(paras[0]);
-			}
-
-			// object disappear when drop into trashcan
-			r = Relation("NEXT", "Imitator", "Trashcan");
-			
-			// check if there is trashcan next to it, if not add "NEXT imitator objA", otherwise the objA will be disappear	
-			p=find(nextState.begin(), nextState.end(), r);
-			if (p==nextState.end())
-				// there is no trashcan next to it, add additional relation to the next state.
-				nextState.add(Relation("NEXT","Imitator",preConds[0].objB));
-			break;
+				p = find(nextState.begin(), nextState.end(), Relation(SYM_NEXT, SYM_IMITATOR, SYM_WILDCARD));
+				if (p!=nextState.end())
+				{
+					if (nextState.nextTo.empty())
+						nextState.nextTo.add(p->objB);
+					nextState.nextTo.add(object);
+				}
+				break;
+			case PLACE:
+				// check if there is trashcan next to it, if not add "NEXT imitator object", otherwise the object disappears
+				p = find(nextState.begin(), nextState.end(), Relation(SYM_NEXT, SYM_IMITATOR, SYM_TRASHCAN));
+				if (p==nextState.end())
+					nextState.add(Relation(SYM_NEXT, SYM_IMITATOR, object));
+				break;
+		}
 	}
 
 	// add postcond to next state
@@ -159,12 +151,75 @@ State Action::Execute(const State& currState)
 	Desc.	: check whether this instance's precondition is satisfied by the current state
 	Para.	: currState, current state
 	Return	: bool, true when satisfied, otherwise false.
+	Note	: a mask test when both states are kept as bits, see State::operator>=
 */
-bool Action::IsSatisfied(State currState)
+bool Action::IsSatisfied(const State& currState) const
 {
 	return (currState >= preConds);
 }
 
+/*
+	Function: arity()
+	Desc.	: number of parameters of this instance
+	Para.	: None
+	Return	: 2 when PARA_2 is in the conditions, 1 when only PARA_1 is, otherwise 0
+*/
+int Action::arity() const
+{
+	int i, n = 0;
+	const State *conds[] = {&preConds, &postConds};
+
+	for (int k=0; k<2; ++k)
+		for (i=0; i<conds[k]->size(); ++i)
+		{
+			const Relation& r = (*conds[k])[i];
+			if (r.objA == SYM_PARA_2 || r.objB == SYM_PARA_2)
+				return 2;
+			if (r.objA == SYM_PARA_1 || r.objB == SYM_PARA_1)
+				n = 1;
+		}
+
+	return n;
+}
+
+/*
+	Function: allows()
+	Desc.	: check whether a parameter may take the given object
+	Para.	: para, 0 for PARA_1, 1 for PARA_2
+			  object, name of an internal object
+	Return	: true when the object is in the domain of the parameter or the parameter has no domain
+*/
+bool Action::allows(int para, Symbol object) const
+{
+	if (para >= (int)domains.size() || domains[para].empty())
+		return true;
+
+	return (find(domains[para].begin(), domains[para].end(), object) != domains[para].end());
+}
+
+/*
+	Function: addEffect()
+	Desc.	: add an effect at the end of the effects of this instance
+	Para.	: effectName, AWAY, CARRY, LEAVE, JOIN, GROUP, PLACE or REPEAT
+			  para, 0 for PARA_1, 1 for PARA_2
+	Return	: false when there is no effect of that name
+*/
+bool Action::addEffect(const string& effectName, int para)
+{
+	static const char *names[] = {"AWAY", "CARRY", "LEAVE", "JOIN", "GROUP", "PLACE", "REPEAT"};
+	Effect e;
+
+	for (e.type=AWAY_OTHERS; e.type<=REPEAT; ++e.type)
+		if (effectName == names[e.type])
+		{
+			e.para = para;
+			effects.push_back(e);
+			return true;
+		}
+
+	return false;
+}
+
 /*
 	Function: clear()
 	Desc.	: clean this instance.
@@ -177,6 +232,8 @@ void Action::clear()
 	name.clear();
 	preConds.clear();
 	postConds.clear();
+	domains.clear();
+	effects.clear();
 	cost = 0;
 }
 
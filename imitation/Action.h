@@ -10,9 +10,9 @@ using namespace std;
 
 class Action
 {
-	void parameterize(State& state, string p1, string p2);
+	void parameterize(State& state, Symbol p1, Symbol p2);
 
-	vector<string> paras;	// parameter for execution
+	vector<Symbol> paras;	// parameter for execution
 
 public:
 	int	num;
@@ -21,22 +21,60 @@ public:
 	State postConds;		// postcondition, vary
 	double cost;			// cost of the action
 
+	// objects each parameter may take, by name, any internal object when a parameter has none
+	vector<vector<Symbol> > domains;
+
+	// effects which depend on the rest of the state, by their name in actions.txt
+	enum {
+		AWAY_OTHERS,	// AWAY, the NEXT relations left become AWAY
+		CARRY,			// CARRY PARA_n, the imitator gets next to the objects which are next to the parameter
+		LEAVE,			// LEAVE PARA_n, the parameter leaves the objects which are next to each other
+		JOIN,			// JOIN PARA_n, the parameter joins the objects which are next to each other
+		GROUP,			// GROUP PARA_n, the parameter and the object next to the imitator are next to each other
+		PLACE,			// PLACE PARA_n, the imitator is next to the parameter unless it is next to the trashcan
+		REPEAT			// REPEAT PARA_n, the parameter is added again when it is next to other objects, see ObjectSet
+	};
+
+	// an effect and its parameter, 0 for PARA_1 and 1 for PARA_2
+	struct Effect
+	{
+		int type;
+		int para;
+	};
+
+	// applied in order between the removal of the preconditions and the addition of the postconditions
+	vector<Effect> effects;
+
 	Action(void);
 	Action(int numVal, string nameVal, State preCondsVal, State postCondsVal, double costVal);
 
 	~Action(void);
 
+	Action(const Action& a) = default;
+	Action(Action&& a) = default;
+	Action& operator=(const Action& a) = default;
+	Action& operator=(Action&& a) = default;
+
 	// clean this instance.
 	void clear();
+
+	// add an effect by its name, false when there is no effect of that name
+	bool addEffect(const string& effectName, int para);
 	
 	// Given a state, execute this instance and return next state
-	State Execute(const State& currState);
+	State Execute(const State& currState) const;
 	
 	// check whether this instance's precondition is satisfied by the current state
-	bool IsSatisfied(State currState) ;
+	bool IsSatisfied(const State& currState) const;
+
+	// number of parameters, PARA_1 and PARA_2 in the conditions
+	int arity() const;
+
+	// check whether a parameter may take the given object
+	bool allows(int para, Symbol object) const;
 
 	// Fill this instance with real parameter
-	void parameterize(string p1, string p2);
+	void parameterize(Symbol p1, Symbol p2);
 
 	// Returns a String that represents this instance
 	string toString() const;
@@ -0,0 +1,53 @@
+#include "ActionTable.h"
+
+ActionTable::ActionTable(void) {}
+
+/*
+	Function: ActionTable()
+	Desc.	: ground the actions with the internal objects
+	Para.	: actions, the primitive actions
+			  intObjects, the internal objects
+	Return	: None
+	Note	: the two parameters of an action always take different objects
+*/
+ActionTable::ActionTable(const vector<Action>& actions, const vector<Object>& intObjects)
+{
+	size_t i, j, k;
+	Action a;
+
+	for (i=0; i<actions.size(); ++i)
+	{
+		const int n = actions[i].arity();
+
+		if (n == 0)
+		{
+			grounded.push_back(actions[i]);
+			grounded.back().parameterize(Symbol(), Symbol());
+			continue;
+		}
+
+		for (j=0; j<intObjects.size(); ++j)
+		{
+			if (!actions[i].allows(0, intObjects[j].name))
+				continue;
+
+			if (n == 1)
+			{
+				grounded.push_back(actions[i]);
+				grounded.back().parameterize(intObjects[j].name, Symbol());
+				continue;
+			}
+
+			for (k=0; k<intObjects.size(); ++k)
+			{
+				if (k == j || !actions[i].allows(1, intObjects[k].name))
+					continue;
+
+				grounded.push_back(actions[i]);
+				grounded.back().parameterize(intObjects[j].name, intObjects[k].name);
+			}
+		}
+	}
+}
+
+ActionTable::~ActionTable(void) {}
@@ -0,0 +1,33 @@
+#ifndef ACTIONTABLE_H
+#define ACTIONTABLE_H
+
+#include <vector>
+
+#include "Action.h"
+#include "Object.h"
+
+using namespace std;
+
+/*
+	The primitive actions grounded with one set of internal objects. Each action is parameterized once 
+	with the objects its parameters may take (see Action::domains), so generating the successors of a 
+	state only tests the precondition bits of the grounded actions and executes the satisfied ones, 
+	no action is copied or parameterized again.
+*/
+class ActionTable
+{
+	// in the order of the actions, then of the internal objects taken by PARA_1 and by PARA_2
+	vector<Action> grounded;
+
+public:
+	ActionTable(void);
+	ActionTable(const vector<Action>& actions, const vector<Object>& intObjects);
+	~ActionTable(void);
+
+	// number of grounded actions
+	size_t size() const { return grounded.size(); }
+
+	const Action& operator[](size_t i) const { return grounded[i]; }
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "BeamLevels.h"
+
+BeamLevels::BeamLevels(void) : width(0), pruned(0) {}
+
+BeamLevels::~BeamLevels(void) {}
+
+void BeamLevels::reset(size_t widthVal)
+{
+	width = widthVal;
+	open.clear();
+	count.clear();
+	pruned = 0;
+}
+
+void BeamLevels::grow(int level)
+{
+	if (level >= (int)count.size())
+	{
+		open.resize(level+1);
+		count.resize(level+1, 0);
+	}
+}
+
+void BeamLevels::eraseOpen(treeNode *node)
+{
+	pair<multimap<double, treeNode *>::iterator, multimap<double, treeNode *>::iterator> range;
+
+	range = open[node->data.level].equal_range(node->data.f);
+	for (; range.first != range.second; ++range.first)
+		if (range.first->second == node)
+		{
+			open[node->data.level].erase(range.first);
+			return;
+		}
+}
+
+/*
+	Function: admit()
+	Desc.	: check whether a new node can be put on a level
+	Para.	: level, the level of the new node
+			  f, the cost of the new node
+			  displaced, the open node which has to be removed to make room, 0 when there is room
+	Return	: true when the node can be put on the level
+	Note	: a node which is not better than the worst open node of a full level is pruned, so are the nodes 
+			  of a level whose nodes are all expanded
+*/
+bool BeamLevels::admit(int level, double f, treeNode *&displaced)
+{
+	displaced = 0;
+	if (width == 0)
+		return true;
+
+	grow(level);
+	if (count[level] < width)
+		return true;
+
+	++pruned;
+	if (open[level].empty() || f >= (--open[level].end())->first)
+		return false;
+
+	displaced = (--open[level].end())->second;
+	return true;
+}
+
+void BeamLevels::insert(treeNode *node)
+{
+	if (width == 0)
+		return;
+
+	grow(node->data.level);
+	open[node->data.level].insert(make_pair(node->data.f, node));
+	++count[node->data.level];
+}
+
+void BeamLevels::close(treeNode *node)
+{
+	if (width == 0)
+		return;
+
+	eraseOpen(node);
+}
+
+void BeamLevels::erase(treeNode *node)
+{
+	if (width == 0)
+		return;
+
+	eraseOpen(node);
+	--count[node->data.level];
+}
@@ -0,0 +1,61 @@
+#ifndef BEAMLEVELS_H
+#define BEAMLEVELS_H
+
+#include <vector>
+#include <map>
+
+#include "OpenList.h"
+
+using namespace std;
+
+// default number of nodes kept on each level of the A* tree by the beam search
+#define DEFAULT_BEAM_WIDTH 8
+
+/*
+	Bookkeeping of the beam search: each level of the A* tree (Node::level) holds at most width nodes.
+	The nodes of a level which are still on the open list are kept ordered by f, so when the level is
+	full a better node can take the place of the worst open one. Expanded nodes keep their place,
+	so at most width nodes are expanded on each level and the tree doesn't grow beyond
+	width nodes per level.
+*/
+class BeamLevels
+{
+	size_t width;
+
+	// open nodes of each level ordered by f, and the number of nodes of each level in the tree
+	vector<multimap<double, treeNode *> > open;
+	vector<size_t> count;
+
+	void grow(int level);
+
+	// remove a node from the open nodes of its level, nothing happens if it isn't there
+	void eraseOpen(treeNode *node);
+
+public:
+	// number of nodes which were pruned or not let in
+	long pruned;
+
+	BeamLevels(void);
+	~BeamLevels(void);
+
+	// start a new search, width 0 means no limit
+	void reset(size_t widthVal);
+
+	// whether the levels are bounded
+	bool active() const { return width != 0; }
+
+	// whether a new node with cost f can be put on the given level, displaced is set to the open node 
+	// it takes the place of, 0 when there is room
+	bool admit(int level, double f, treeNode *&displaced);
+
+	// a node is added to the tree and the open list
+	void insert(treeNode *node);
+
+	// a node is taken from the open list to be expanded, it stays in the tree
+	void close(treeNode *node);
+
+	// a node is removed from the tree
+	void erase(treeNode *node);
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "DistanceCache.h"
+#include "Utility.h"
+
+DistanceCache::DistanceCache(size_t capacityVal) : version(-1), capacity(capacityVal), hits(0), misses(0) {}
+
+DistanceCache::~DistanceCache(void) {}
+
+size_t DistanceCache::key(const InternalState& s)
+{
+	return s.state->hash() ^ mixHash(s.extStateNum);
+}
+
+/*
+	Function: check()
+	Desc.	: make sure the entries belong to the given problem, forget them otherwise
+	Para.	: observedObjectsVal, observedStatesVal, the observed model
+			  intObjectsVal, the internal objects
+	Return	: None
+*/
+void DistanceCache::check(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal)
+{
+	bool same = (sameObjects(intObjects, intObjectsVal) && sameObjects(observedObjects, observedObjectsVal) && 
+		observedStates.size() == observedStatesVal.size());
+
+	for (size_t i=0; same && i<observedStates.size(); ++i)
+		same = observedStates[i].identical(observedStatesVal[i]);
+
+	if (same)
+		return;
+
+	entries.clear();
+	observedObjects = observedObjectsVal;
+	observedStates = observedStatesVal;
+	intObjects = intObjectsVal;
+}
+
+// forget the entries when they were computed with another version of the network
+void DistanceCache::check(long versionVal)
+{
+	if (versionVal == version)
+		return;
+
+	entries.clear();
+	version = versionVal;
+}
+
+/*
+	Function: find()
+	Desc.	: look up the distance of an internal state to its observed state
+	Para.	: s, internal state
+			  distance, set to the distance when it is found
+	Return	: true when the distance is found
+	Note	: the relations must be in the same order, the network input depends on it
+*/
+bool DistanceCache::find(const InternalState& s, double& distance)
+{
+	pair<unordered_multimap<size_t, Entry>::const_iterator, unordered_multimap<size_t, Entry>::const_iterator> range;
+
+	range = entries.equal_range(key(s));
+	for (; range.first != range.second; ++range.first)
+	{
+		const Entry& e = range.first->second;
+		if (e.extStateNum == s.extStateNum && e.state.identical(s.state))
+		{
+			++hits;
+			distance = e.distance;
+			return true;
+		}
+	}
+
+	++misses;
+	return false;
+}
+
+/*
+	Function: insert()
+	Desc.	: keep the distance of an internal state to its observed state
+	Para.	: s, internal state
+			  distance, the distance
+	Return	: None
+	Note	: a full cache is emptied first, the entries of the current search come back quickly
+*/
+void DistanceCache::insert(const InternalState& s, double distance)
+{
+	Entry e;
+
+	if (entries.size() >= capacity)
+		entries.clear();
+
+	e.extStateNum = s.extStateNum;
+	e.state = s.state;
+	e.distance = distance;
+	entries.insert(make_pair(key(s), e));
+}
+
+void DistanceCache::clear()
+{
+	entries.clear();
+}
+
+void DistanceCache::resetCounters()
+{
+	hits = 0;
+	misses = 0;
+}
+
+size_t DistanceCache::size() const
+{
+	return entries.size();
+}
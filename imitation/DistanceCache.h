@@ -0,0 +1,73 @@
+#ifndef DISTANCECACHE_H
+#define DISTANCECACHE_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "InternalState.h"
+#include "Object.h"
+#include "State.h"
+
+using namespace std;
+
+// maximum number of distances kept, the cache is emptied when it is full
+#define DISTANCE_CACHE_SIZE 65536
+
+/*
+	Distances given by the network, keyed by the pair of an observed state and an internal state of
+	the current problem (observed model and internal objects). A hit saves the conversion to the
+	network input as well as the network itself.
+	The entries are only valid for the problem and the weights they were computed with, so the cache
+	keeps both and forgets everything when either of them changes. Comparing the problem takes a pass
+	over its states, so it is checked when a search begins, and only the version of the network before
+	each lookup.
+*/
+class DistanceCache
+{
+	struct Entry
+	{
+		int extStateNum;
+		SharedState state;		// shared with the internal state it was computed for
+		double distance;
+	};
+
+	unordered_multimap<size_t, Entry> entries;
+
+	// the problem and the version of the network the entries were computed with
+	vector<Object> observedObjects;
+	vector<State> observedStates;
+	vector<Object> intObjects;
+	long version;
+
+	size_t capacity;
+
+	static size_t key(const InternalState& s);
+
+public:
+	// number of lookups which found/didn't find the distance
+	long hits, misses;
+
+	DistanceCache(size_t capacityVal = DISTANCE_CACHE_SIZE);
+	~DistanceCache(void);
+
+	// forget the entries when the problem has changed, once for each search
+	void check(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal);
+
+	// forget the entries when the network has changed, before each lookup
+	void check(long versionVal);
+
+	// look up the distance of an internal state to its observed state
+	bool find(const InternalState& s, double& distance);
+
+	// keep the distance of an internal state to its observed state
+	void insert(const InternalState& s, double distance);
+
+	// remove all the entries
+	void clear();
+
+	void resetCounters();
+
+	size_t size() const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "EmbeddingTable.h"
+
+#include <algorithm>
+
+EmbeddingTable::EmbeddingTable(void) : nn(0), extEncoder(0), intEncoder(0), version(-1), extBuild(-1), intBuild(-1), width(0) {}
+
+EmbeddingTable::~EmbeddingTable(void) {}
+
+/*
+	Function: check()
+	Desc.	: make sure the rows belong to the given network and encoders, forget them otherwise
+	Para.	: nnVal, the network
+			  extEncoderVal, intEncoderVal, the encoders of the observed and of the internal states
+	Return	: None
+*/
+void EmbeddingTable::check(const FeedForward& nnVal, const FeatureEncoder& extEncoderVal, const FeatureEncoder& intEncoderVal)
+{
+	int slot, n = 0;
+
+	if (nn == &nnVal && version == nnVal.getVersion() && extEncoder == &extEncoderVal && extBuild == extEncoderVal.build() && 
+		intEncoder == &intEncoderVal && intBuild == intEncoderVal.build())
+		return;
+
+	nn = &nnVal;
+	extEncoder = &extEncoderVal;
+	intEncoder = &intEncoderVal;
+	version = nnVal.getVersion();
+	extBuild = extEncoderVal.build();
+	intBuild = intEncoderVal.build();
+
+	firstRow.clear();
+	for (slot=0; slot<extEncoder->slots(); ++slot)
+	{
+		firstRow.push_back(n);
+		n += extEncoder->numOfValues(slot);
+	}
+	for (slot=0; slot<intEncoder->slots(); ++slot)
+	{
+		firstRow.push_back(n);
+		n += intEncoder->numOfValues(slot);
+	}
+
+	width = nn->numOfHidden();
+	rows.resize((size_t)n * width);
+	ready.assign(n, 0);
+	values.resize(firstRow.size());
+	sums.resize(width);
+}
+
+/*
+	Function: row()
+	Desc.	: the weighted sums of the features of one value of a slot, worked out the first time
+	Para.	: slot, a slot of the observed state or, after them, of the internal state
+			  k, the value, as given by FeatureEncoder::index()
+	Return	: the row, width numbers
+	Note	: the features of slot s are the input elements 4s to 4s+3, the internal state's follow the
+			  observed state's
+*/
+const double *EmbeddingTable::row(int slot, int k)
+{
+	const int extSlots = extEncoder->slots();
+	const int r = firstRow[slot] + k;
+	double features[4];
+
+	if (!ready[r])
+	{
+		if (slot < extSlots)
+			extEncoder->value(slot, k, features);
+		else
+			intEncoder->value(slot - extSlots, k, features);
+
+		nn->embed(features, 4*slot, 4, &rows[(size_t)r * width]);
+		ready[r] = 1;
+	}
+
+	return &rows[(size_t)r * width];
+}
+
+/*
+	Function: evaluate()
+	Desc.	: network output of a pair of states, from the rows of the values of their slots
+	Para.	: extState, the observed state
+			  intState, the internal state
+	Return	: double
+	Note	: the sums are done in another order than FeedForward::evaluate(), the output can differ in
+			  the last digits
+*/
+double EmbeddingTable::evaluate(const State& extState, const State& intState)
+{
+	const int extSlots = extEncoder->slots();
+	const double *r;
+	size_t slot;
+	int i;
+
+	extEncoder->index(extState, &values[0]);
+	intEncoder->index(intState, &values[extSlots]);
+
+	fill(sums.begin(), sums.end(), 0.0);
+	for (slot=0; slot<values.size(); ++slot)
+	{
+		r = row((int)slot, values[slot]);
+		for (i=0; i<width; ++i)
+			sums[i] += r[i];
+	}
+
+	return nn->evaluateSums(&sums[0]);
+}
@@ -0,0 +1,53 @@
+#ifndef EMBEDDINGTABLE_H
+#define EMBEDDINGTABLE_H
+
+#include <vector>
+
+#include "FeedForward.h"
+#include "FeatureEncoder.h"
+#include "State.h"
+
+using namespace std;
+
+/*
+	The network's hidden layer for the input of the current problem, as table rows. The four features
+	of a slot (an object or the gripper, of the observed or of the internal state) only take a few
+	values, so the weighted sums of the features of each value for the hidden units are kept in a row.
+	The input of a pair of states is then one row added for each slot instead of a multiplication for
+	each input element and hidden unit.
+	A row is worked out the first time its value is met. The rows are only valid for the weights and
+	the encoders they were computed with, so the table keeps their versions and forgets the rows when
+	one of them changes, which is after each training update.
+*/
+class EmbeddingTable
+{
+	// what the rows were computed with
+	const FeedForward *nn;
+	const FeatureEncoder *extEncoder, *intEncoder;
+	long version;
+	int extBuild, intBuild;
+
+	int width;					// numbers in a row, one for each hidden unit
+	vector<int> firstRow;		// row of the first value of each slot, the observed state's slots first
+	vector<double> rows;
+	vector<char> ready;			// whether each row has been worked out
+
+	// buffers of evaluate()
+	vector<int> values;
+	vector<double> sums;
+
+	// row of a value of a slot
+	const double *row(int slot, int k);
+
+public:
+	EmbeddingTable(void);
+	~EmbeddingTable(void);
+
+	// forget the rows when the network or one of the encoders has changed
+	void check(const FeedForward& nnVal, const FeatureEncoder& extEncoderVal, const FeatureEncoder& intEncoderVal);
+
+	// network output of an observed state and an internal state
+	double evaluate(const State& extState, const State& intState);
+};
+
+#endif
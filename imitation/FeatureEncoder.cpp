@@ -0,0 +1,197 @@
+#include "FeatureEncoder.h"
+#include "Utility.h"
+
+#include <algorithm>
+
+FeatureEncoder::FeatureEncoder(void) : numMap(0), actorCode(0), onCode(0), gripperCode(0), builds(0) {}
+
+FeatureEncoder::~FeatureEncoder(void) {}
+
+double FeatureEncoder::code(const Symbol& s) const
+{
+	return (size_t)s.num() < codes.size() ? codes[s.num()] : 0;
+}
+
+int FeatureEncoder::object(const Symbol& name) const
+{
+	return (size_t)name.num() < firstObject.size() ? firstObject[name.num()] : -1;
+}
+
+/*
+	Function: check()
+	Desc.	: make sure this instance encodes the given objects with the given map and actor, build it otherwise
+	Para.	: objectsVal, the objects of the states
+			  numMapVal, numeric representation of the symbols
+			  actorVal, the demonstrator or the imitator
+	Return	: None
+*/
+void FeatureEncoder::check(const vector<Object>& objectsVal, const map<Symbol, double>& numMapVal, const Symbol& actorVal)
+{
+	map<Symbol, double>::const_iterator p;
+	int i;
+
+	if (numMap == &numMapVal && actor == actorVal && sameObjects(objects, objectsVal))
+		return;
+
+	objects = objectsVal;
+	numMap = &numMapVal;
+	actor = actorVal;
+
+	codes.assign(Symbol::count(), 0);
+	for (p = numMap->begin(); p != numMap->end(); ++p)
+		codes[p->first.num()] = p->second;
+
+	// objects with the same name are chained, the first one is found like find_if would
+	firstObject.assign(Symbol::count(), -1);
+	nextObject.assign(objects.size(), -1);
+	for (i=(int)objects.size()-1; i>=0; --i)
+	{
+		nextObject[i] = firstObject[objects[i].name.num()];
+		firstObject[objects[i].name.num()] = i;
+	}
+
+	attributes.resize(2*objects.size());
+	for (i=0; i<(int)objects.size(); ++i)
+	{
+		attributes[2*i] = code(objects[i].color);
+		attributes[2*i+1] = code(objects[i].texture);
+	}
+
+	actorCode = code(actor);
+	onCode = code(SYM_ON);
+	gripperCode = code(SYM_GRIPPER);
+
+	++builds;
+}
+
+int FeatureEncoder::size() const
+{
+	return 4*((int)objects.size() + 1);
+}
+
+int FeatureEncoder::build() const
+{
+	return builds;
+}
+
+int FeatureEncoder::slots() const
+{
+	return (int)objects.size() + 1;
+}
+
+/*
+	Function: numOfValues()
+	Desc.	: number of values the four features of a slot can take
+	Para.	: slot, an object or slots()-1 for the gripper
+	Return	: for an object, one for no relation with the actor, one for each symbol of the table and one
+			  for the later symbols. For the gripper, one for nothing on it and one for each object
+*/
+int FeatureEncoder::numOfValues(int slot) const
+{
+	return slot < (int)objects.size() ? (int)codes.size() + 2 : (int)objects.size() + 1;
+}
+
+/*
+	Function: value()
+	Desc.	: the four features of one value of a slot, the numbers encode() writes for it
+	Para.	: slot, an object or slots()-1 for the gripper
+			  k, the value, see index()
+			  features, output, four numbers
+	Return	: None
+*/
+void FeatureEncoder::value(int slot, int k, double *features) const
+{
+	if (slot == (int)objects.size())
+	{
+		features[0] = onCode;
+		features[1] = gripperCode;
+		features[2] = k > 0 ? attributes[2*(k-1)] : 0;
+		features[3] = k > 0 ? attributes[2*(k-1)+1] : 0;
+	}
+	else if (k == 0)
+		fill(features, features + 4, 0.0);
+	else
+	{
+		features[0] = k-1 < (int)codes.size() ? codes[k-1] : 0;
+		features[1] = actorCode;
+		features[2] = attributes[2*slot];
+		features[3] = attributes[2*slot+1];
+	}
+}
+
+/*
+	Function: index()
+	Desc.	: the value of each slot of a state
+	Para.	: state, a state of the objects of this instance
+			  values, output, slots() numbers
+	Return	: None
+	Note	: an object in a relation with the actor has 1 plus the number of the relation's symbol, the
+			  symbols after the table share the last value. The gripper has 1 plus the object on it. The
+			  relations are read as encode() reads them
+*/
+void FeatureEncoder::index(const State& state, int *values) const
+{
+	const int gripper = (int)objects.size(), later = (int)codes.size();
+	State::const_iterator p;
+	int i, held = -1;
+
+	fill(values, values + slots(), 0);
+
+	for (p = state.end(); p != state.begin(); )
+	{
+		--p;
+		if (p->objA == actor)
+			for (i = object(p->objB); i != -1; i = nextObject[i])
+				values[i] = 1 + min(p->relation.num(), later);
+
+		if (p->relation == SYM_ON && p->objA == SYM_GRIPPER)
+			held = p->objB == SYM_NULL ? -1 : object(p->objB);
+	}
+
+	values[gripper] = held + 1;
+}
+
+/*
+	Function: encode()
+	Desc.	: numeric representation of a state, encoding both the relations and the objects' attributes
+	Para.	: state, a state of the objects of this instance
+			  features, output, size() numbers
+	Return	: None
+	Note	: an object takes the first relation between the actor and it, so the relations are read from
+			  the last one and the earlier ones overwrite the later ones. Objects which aren't in a relation
+			  with the actor, and the gripper when nothing or an unknown object is on it, get zeros
+*/
+void FeatureEncoder::encode(const State& state, double *features) const
+{
+	const int gripper = 4*(int)objects.size();
+	State::const_iterator p;
+	int i, held = -1;
+
+	fill(features, features + size(), 0.0);
+
+	for (p = state.end(); p != state.begin(); )
+	{
+		--p;
+		if (p->objA == actor)
+		{
+			for (i = object(p->objB); i != -1; i = nextObject[i])
+			{
+				features[4*i] = code(p->relation);
+				features[4*i+1] = actorCode;
+				features[4*i+2] = attributes[2*i];
+				features[4*i+3] = attributes[2*i+1];
+			}
+		}
+
+		if (p->relation == SYM_ON && p->objA == SYM_GRIPPER)
+			held = p->objB == SYM_NULL ? -1 : object(p->objB);
+	}
+
+	features[gripper] = onCode;
+	features[gripper+1] = gripperCode;
+	if (held >= 0)
+	{
+		features[gripper+2] = attributes[2*held];
+		features[gripper+3] = attributes[2*held+1];
+	}
+}
@@ -0,0 +1,76 @@
+#ifndef FEATUREENCODER_H
+#define FEATUREENCODER_H
+
+#include <vector>
+#include <map>
+
+#include "Object.h"
+#include "State.h"
+#include "Symbol.h"
+
+using namespace std;
+
+/*
+	Numeric representation of the states of one set of objects, as the network input. Each object has
+	four features at a fixed offset (relation to the actor, actor, color, texture) and the gripper has
+	the last four (ON, Gripper, color and texture of the object on it).
+	Everything which doesn't depend on the state is worked out when the encoder is built: the numeric
+	code of each symbol in a table indexed by the symbol number, the object of each name and the codes
+	of the object attributes. Encoding a state is then one pass over its relations writing into the
+	caller's buffer, instead of a search of the relations for each object and a map lookup for each
+	feature.
+	The four features of an object, or of the gripper, only take a few values: one for each relation
+	between the actor and the object, or for each object on the gripper. index() gives the number of
+	the value of each of them instead of the features, for tables with a row per value.
+*/
+class FeatureEncoder
+{
+	// what the encoder was built for
+	vector<Object> objects;
+	const map<Symbol, double> *numMap;
+	Symbol actor;
+
+	vector<double> codes;			// numeric code of each symbol by number, the symbols after the table are 0
+	vector<int> firstObject;		// first object with each name by symbol number, -1 for none
+	vector<int> nextObject;			// next object with the same name, -1 for none
+	vector<double> attributes;		// color and texture codes of each object
+
+	double actorCode, onCode, gripperCode;
+
+	// number of times this instance was built
+	int builds;
+
+	// numeric code of a symbol, 0 when it isn't in the map
+	double code(const Symbol& s) const;
+
+	// first object with the given name, -1 for none
+	int object(const Symbol& name) const;
+
+public:
+	FeatureEncoder(void);
+	~FeatureEncoder(void);
+
+	// build this instance for the given objects, map and actor, unless it was built for them
+	void check(const vector<Object>& objectsVal, const map<Symbol, double>& numMapVal, const Symbol& actorVal);
+
+	// number of features, four for each object and four for the gripper
+	int size() const;
+
+	// changes whenever this instance is built for other objects, map or actor
+	int build() const;
+
+	// number of slots of four features, one for each object and the last one for the gripper
+	int slots() const;
+
+	// number of values the features of a slot can take, and the four features of one of them
+	int numOfValues(int slot) const;
+	void value(int slot, int k, double *features) const;
+
+	// write the number of the value of each slot of a state into values, slots() numbers
+	void index(const State& state, int *values) const;
+
+	// write the features of a state into features, size() numbers
+	void encode(const State& state, double *features) const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "FeedForward.h"
 
-FeedForward::FeedForward(void)
+FeedForward::FeedForward(void) : iWeights(0), iWGradient(0), hBias(0), hBGradient(0), hWeights(0), hWGradient(0), oBias(0), 
+	oBGradient(0)
 {
 	// initially the expected reward is zero. It is read from nn.txt if exists
 	expectedReward = 0;
@@ -22,7 +23,7 @@ FeedForward::~FeedForward(void){}
 	Para	: x, input
 	Return	: double, output of hidden unit
 */
-double FeedForward::calcHiddenTrans(double x)
+double FeedForward::calcHiddenTrans(double x) const
 {
 	//return 2.0/(1 + exp(-2*x)) - 1;	// tansig
 
@@ -48,7 +49,7 @@ double FeedForward::calcHiddenDerivative(int i)
 	Para	: x, output unit's input parameters
 	Return	: double
 */
-double FeedForward::calcOutputTrans(double x)
+double FeedForward::calcOutputTrans(double x) const
 {
 	// here purelin used
 	return x;
@@ -66,6 +67,7 @@ void FeedForward::create(int numOfInput, int numOfHiddenUnit, vector<vector<doub
 {
 	_numOfInput = numOfInput;
 	_numOfHidden = numOfHiddenUnit;
+	layout();
 
 	// initialize other vector variables
 	initGradient();
@@ -73,6 +75,7 @@ void FeedForward::create(int numOfInput, int numOfHiddenUnit, vector<vector<doub
 	// initialize the network using Nguyen-Widrow algorithm
 	//NguyenWidrow(s);
 	randomInit();
+	++version;
 }
 
 /*
@@ -90,9 +93,6 @@ void FeedForward::create(int numOfInput, int numOfHiddenUnit, vector<vector<doub
 void FeedForward::create(string fileName)
 {
 	int i, j;
-	double input;
-
-	vector<double> weight;
 
 	fstream fin;
 	
@@ -104,38 +104,25 @@ void FeedForward::create(string fileName)
 	fin >> _numOfHidden;
 	fin >> _numOfInput;
 
-	// clear weight vectors
-	iWeights.clear();
-	hBias.clear();
-	hWeights.clear();
+	// new weight blocks
+	layout();
+	++version;
 
 	//weight factor on the link between input unit and hidden units
 	for (i=0; i<_numOfHidden; ++i)
-	{
-		weight.clear();
 		for (j=0; j<_numOfInput; ++j)
-		{
-			fin >> input;
-			weight.push_back(input);
-		}
-		iWeights.push_back(weight);
-	}
+			fin >> iWeights[i*_numOfInput + j];
 
 	// bias on each hidden unit
 	for (i=0; i<_numOfHidden; ++i)
-	{
-		fin >> input;
-		hBias.push_back(input);
-	}
+		fin >> hBias[i];
 
 	// weight factor on the link between hidden unit and output unit
 	for (i=0; i<_numOfHidden; ++i)
-	{
-		fin >> input;
-		hWeights.push_back(input);
-	}
+		fin >> hWeights[i];
+
 	// bias on output unit
-	fin >> oBias;
+	fin >> *oBias;
 
 	// close file
 	fin.close();
@@ -152,7 +139,8 @@ void FeedForward::create(string fileName)
 */
 double FeedForward::calcGradientDescent (vector<vector<double> > &inputs, vector<double> &expectedOutputs)
 {
-	size_t num, i, j;
+	size_t num;
+	int i, j;
 	double err, errSum, numFactor;
 
 	// set gradient descent variable to zero
@@ -168,8 +156,8 @@ double FeedForward::calcGradientDescent (vector<vector<double> > &inputs, vector
 		errSum += pow(err,2);
 		
 		// calculate gradient descent of output unit's bias
-		oBGradient += -err*numFactor;
-		for (i=0; i<iWeights.size(); ++i)			// number of hidden unit
+		*oBGradient += -err*numFactor;
+		for (i=0; i<_numOfHidden; ++i)			// number of hidden unit
 		{
 			// calculate gradient descent of weight between hidden unit and output unit
 			hWGradient[i] += -err * hOutput[i] * numFactor;
@@ -178,8 +166,8 @@ double FeedForward::calcGradientDescent (vector<vector<double> > &inputs, vector
 			hBGradient[i] += -err*hWeights[i]*calcHiddenDerivative(i)*numFactor;
 
 			// calculate gradient descent of weight between input unit and hidden unit
-			for (j=0; j<iWeights[i].size(); ++j)
-				iWGradient[i][j] += -err*hWeights[i]*calcHiddenDerivative(i)*inputs[num][j]*numFactor;
+			for (j=0; j<_numOfInput; ++j)
+				iWGradient[i*_numOfInput + j] += -err*hWeights[i]*calcHiddenDerivative(i)*inputs[num][j]*numFactor;
 		}
 	}
 	
@@ -187,50 +175,27 @@ double FeedForward::calcGradientDescent (vector<vector<double> > &inputs, vector
 }
 
 /*
-	Function: getWeights()
-	Desc	: store the address of weight factor and gradient descent in a single vector
+	Function: layout()
+	Desc	: allocate the blocks of the parameters and their gradient, and set the views into them
 	Para	: None
 	Return	: None
+	Note	: order: input weight row by row, hidden unit's bias, hidden unit's weight and output unit's bias.
+			  The parameters are all 0
 */
-void FeedForward::getWeights()
+void FeedForward::layout()
 {
-	size_t i, j, k;
-
 	// number of parameters = numOfHidden * (numOfInput+1) + numOfHidden + 1
-	numOfPara = _numOfHidden * (_numOfInput + 1) + _numOfHidden + 1;
-
-	weightAddr = new double * [numOfPara];
-	gradientAddr = new double * [numOfPara];
+	allocate(_numOfHidden * (_numOfInput + 1) + _numOfHidden + 1);
 
-	// order: input weight, hidden unit's bias, hidden unit's weight and output unit's bias
-	k=0;
-	for (i=0; i<iWeights.size(); ++i)	// the last one is bias
-	{
-		// weight factor between input unit and hidden unit
-		for (j=0; j<iWeights[i].size(); ++j)
-		{
-			weightAddr[k] = &iWeights[i][j];
-			gradientAddr[k++] = &iWGradient[i][j];
-		}
-	}
+	iWeights = weights;
+	hBias = iWeights + _numOfHidden*_numOfInput;
+	hWeights = hBias + _numOfHidden;
+	oBias = hWeights + _numOfHidden;
 
-	for (i=0; i<hBias.size(); ++i)
-	{
-		// bias
-		weightAddr[k] = &hBias[i];
-		gradientAddr[k++] = &hBGradient[i];
-	}
-
-	// for weight factor between hidden unit and output unit
-	for (i=0; i<hWeights.size(); ++i)
-	{
-		weightAddr[k] = &hWeights[i];
-		gradientAddr[k++] = &hWGradient[i];
-	}
-
-	// bias on output unit
-	weightAddr[k] = &oBias;
-	gradientAddr[k++] = &oBGradient;
+	iWGradient = gradients;
+	hBGradient = iWGradient + _numOfHidden*_numOfInput;
+	hWGradient = hBGradient + _numOfHidden;
+	oBGradient = hWGradient + _numOfHidden;
 }
 
 /*
@@ -259,31 +224,31 @@ void FeedForward::save (string fileName)
 */
 void FeedForward::save (fstream &fout)
 {
-	size_t i, j;
+	int i, j;
 	
 	// save expected reward, number of hidden unit and input unit
 	fout << expectedReward << " " << _numOfHidden << " " << _numOfInput << endl;
 	
 	//weight factor between input unit and hidden units
-	for (i=0; i<iWeights.size(); ++i)
+	for (i=0; i<_numOfHidden; ++i)
 	{
-		for (j=0; j<iWeights[i].size(); ++j)
-            fout << iWeights[i][j] << " ";
+		for (j=0; j<_numOfInput; ++j)
+            fout << iWeights[i*_numOfInput + j] << " ";
 		fout << endl;
 	}
 
 	// bias on each hidden unit
-	for (i=0; i<iWeights.size(); ++i)
+	for (i=0; i<_numOfHidden; ++i)
 		fout << hBias[i] << " ";
 	fout << endl;
 
 	// weight factor between hidden unit and output unit
-	for (i=0; i<hWeights.size(); ++i)
+	for (i=0; i<_numOfHidden; ++i)
 		fout << hWeights[i] << " ";
 	fout << endl;
 
 	// bias on the output unit
-	fout << oBias << endl;
+	fout << *oBias << endl;
 }
 
 /*
@@ -299,17 +264,13 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 
 	// rnd is the value from a uniform random distributation between -1 and 1.
 	double rnd, bias, norm, scaleFactor, x, y, sum;
+	double *weight;
 
-	vector<double> weight, xVector, yVector;
+	vector<double> xVector, yVector;
 
 	// minimum and maximum values for each input element
 	vector<vector<double> > range;
 
-	// clear all weight factor
-	iWeights.clear();
-	hBias.clear();
-	hWeights.clear();
-
 	// calculate the min and max of input values
 	range = minMax(s);
 
@@ -331,7 +292,7 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 	for (i=0; i<_numOfHidden; ++i)
 	{
 		norm = 0;
-		weight.clear();
+		weight = iWeights + i*_numOfInput;
 		// weight factor on the link between input unit and hidden unit
 		for (j=0; j<_numOfInput; ++j)
 		{
@@ -343,14 +304,12 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 				// calculate the normalization factor of current hidden unit
 				norm += rnd*rnd;
 			}
-			weight.push_back(rnd);
+			weight[j] = rnd;
 		}
 
 		// adjust the magnitude of weights
 		for (j=0; j<_numOfInput; ++j)
 			weight[j]*=scaleFactor/sqrt(norm);
-		
-		iWeights.push_back(weight);
 
 		// bias for each hidden unit
 		if (i == _numOfHidden-1)
@@ -358,15 +317,15 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 		else
 			bias = -1 + i*2.0/(_numOfHidden-1);
 		
-		bias *= scaleFactor * sign<double>(iWeights[i][idxOfNonConst]);
-		hBias.push_back(bias);
+		bias *= scaleFactor * sign<double>(weight[idxOfNonConst]);
+		hBias[i] = bias;
 
 		// weight factor on the link between hidden unit and output unit
-		hWeights.push_back(r.nextDouble(-1,1));
+		hWeights[i] = r.nextDouble(-1,1);
 	}
 
 	// bias for the output unit
-	oBias = r.nextDouble(-1,1);
+	*oBias = r.nextDouble(-1,1);
 
 	// conversion of net inputs of [-1, 1] to [activeMin, activeMax], [-2, 2] for tansig and [-4, 4] for logsig
 	x = 0.5*(activeRegion[1] - activeRegion[0]);
@@ -375,7 +334,7 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 	for (i=0; i<_numOfHidden; ++i)
 	{
 		for (j=0; j<_numOfInput; ++j)
-			iWeights[i][j]*=x;
+			iWeights[i*_numOfInput + j]*=x;
 
 		hBias[i]=x*hBias[i]+y;
 	}
@@ -403,8 +362,8 @@ void FeedForward::NguyenWidrow(vector<vector<double> > &s)
 		sum=0;
 		for (j=0; j<_numOfInput; ++j)
 		{
-			sum += iWeights[i][j]*yVector[j];
-			iWeights[i][j]*=xVector[j];
+			sum += iWeights[i*_numOfInput + j]*yVector[j];
+			iWeights[i*_numOfInput + j]*=xVector[j];
 		}
 
 		hBias[i] += sum;
@@ -479,16 +438,17 @@ vector<vector<double> > FeedForward::transpose(vector<vector<double> > &v)
 */
 double FeedForward::calcOutput(vector<double> &x)
 {
-	size_t i, j;
+	int i, j;
 	double inputSum, outputSum;
+	const double *w;
 	
 	outputSum=0;
-	for (i=0; i<hWeights.size(); ++i)
+	for (i=0, w=iWeights; i<_numOfHidden; ++i, w+=_numOfInput)
 	{
 		// first, calculate weighted sum of input parameter
 		inputSum=0;
-		for (j=0; j<iWeights[i].size(); ++j)
-			inputSum += x[j]*iWeights[i][j];
+		for (j=0; j<_numOfInput; ++j)
+			inputSum += x[j]*w[j];
 
 		hInput[i] = hBias[i] + inputSum;
 
@@ -497,37 +457,200 @@ double FeedForward::calcOutput(vector<double> &x)
 	
 		outputSum += hOutput[i] * hWeights[i];
 	}
-	outputSum += oBias;
+	outputSum += *oBias;
 
 	//Test(x,outputSum);
 	return calcOutputTrans(outputSum);
 }
 
 /*
-	Function: clearGradient()
-	Desc	: set the gradient descent variables to 0
-	Para	: None
+	Function: evaluate()
+	Desc	: calculate network's output, same as calcOutput() but the hidden units' input/output are not kept
+	Para	: x, input vector
+	Return	: double
+	Note	: it doesn't change the network, so several threads can call it at the same time
+*/
+double FeedForward::evaluate(const vector<double> &x) const
+{
+	int i, j;
+	double inputSum, outputSum;
+	const double *w;
+	
+	outputSum=0;
+	for (i=0, w=iWeights; i<_numOfHidden; ++i, w+=_numOfInput)
+	{
+		// weighted sum of input parameter
+		inputSum=0;
+		for (j=0; j<_numOfInput; ++j)
+			inputSum += x[j]*w[j];
+
+		outputSum += calcHiddenTrans(hBias[i] + inputSum) * hWeights[i];
+	}
+	outputSum += *oBias;
+
+	return calcOutputTrans(outputSum);
+}
+
+/*
+	Function: evaluate()
+	Desc	: calculate network's outputs for a batch of inputs
+	Para	: x, numOfRows input vectors stored one after another, each has _numOfInput elements
+			  numOfRows, number of inputs
+			  outputs, the output of each input
 	Return	: None
+	Note	: the batch goes through one hidden unit at a time, so the unit's weights are read once
+			  for all the inputs. The sums are done in the same order as evaluate(x), the outputs are the same
 */
-void FeedForward::clearGradient()
+void FeedForward::evaluate(const double *x, int numOfRows, double *outputs) const
 {
-	size_t i, j;
+	int i, j, k;
+	double inputSum;
+	const double *row, *w;
 
-	for (i=0; i<iWGradient.size(); ++i)			// number of hidden unit
+	for (k=0; k<numOfRows; ++k)
+		outputs[k] = 0;
+
+	for (i=0; i<_numOfHidden; ++i)
 	{
-		for (j=0; j<iWGradient[i].size(); ++j)	// number of input parameter
-			// clear gradient of hidden unit's weight factor
-			iWGradient[i][j]=0;
+		w = iWeights + i*_numOfInput;
+		for (k=0, row=x; k<numOfRows; ++k, row+=_numOfInput)
+		{
+			// weighted sum of input parameter
+			inputSum=0;
+			for (j=0; j<_numOfInput; ++j)
+				inputSum += row[j]*w[j];
+
+			outputs[k] += calcHiddenTrans(hBias[i] + inputSum) * hWeights[i];
+		}
+	}
 
-		// clear gradient descent of hidden unit's bias
-		hBGradient[i]=0;
+	for (k=0; k<numOfRows; ++k)
+		outputs[k] = calcOutputTrans(outputs[k] + *oBias);
+}
 
-		// clear gradient descent of output unit's weight factor
-		hWGradient[i]=0;
+/*
+	Function: activate()
+	Desc	: keep an input and the input of each hidden unit for it, see evaluate(a, x, changed, numOfChanged)
+	Para	: x, input vector, _numOfInput elements
+			  a, output
+	Return	: None
+	Note	: the sums are done in the same order as evaluate(x)
+*/
+void FeedForward::activate(const double *x, Activation& a) const
+{
+	int i, j;
+	double inputSum;
+	const double *w;
+
+	a.input.assign(x, x + _numOfInput);
+	a.hidden.resize(_numOfHidden);
+	a.version = version;
+
+	for (i=0, w=iWeights; i<_numOfHidden; ++i, w+=_numOfInput)
+	{
+		inputSum=0;
+		for (j=0; j<_numOfInput; ++j)
+			inputSum += x[j]*w[j];
+
+		a.hidden[i] = hBias[i] + inputSum;
 	}
+}
+
+/*
+	Function: evaluate()
+	Desc	: calculate network's output for an input which differs from a kept input in a few elements
+	Para	: a, the kept input, given by activate()
+			  x, input vector
+			  changed, the positions where x differs from the kept input
+			  numOfChanged, number of positions
+	Return	: double
+	Note	: each hidden unit's input is the kept one plus the weighted differences at the changed
+			  positions, numOfChanged multiplications instead of _numOfInput. The sums are done in another
+			  order than evaluate(x), so the output can differ in the last digits. An activation of older
+			  weights isn't used
+*/
+double FeedForward::evaluate(const Activation& a, const double *x, const int *changed, int numOfChanged) const
+{
+	int i, k;
+	double hiddenInput, outputSum;
+	const double *w;
 
-	// clear gradient descent of output unit's bias
-	oBGradient = 0;
+	if (a.version != version)
+	{
+		evaluate(x, 1, &outputSum);
+		return outputSum;
+	}
+
+	outputSum=0;
+	for (i=0, w=iWeights; i<_numOfHidden; ++i, w+=_numOfInput)
+	{
+		hiddenInput = a.hidden[i];
+		for (k=0; k<numOfChanged; ++k)
+			hiddenInput += (x[changed[k]] - a.input[changed[k]])*w[changed[k]];
+
+		outputSum += calcHiddenTrans(hiddenInput) * hWeights[i];
+	}
+	outputSum += *oBias;
+
+	return calcOutputTrans(outputSum);
+}
+
+/*
+	Function: embed()
+	Desc	: weighted sum of a part of an input for each hidden unit, the sums of the parts of an input add up
+			  to the sums of evaluate(x)
+	Para	: values, the input elements first to first+numOfValues-1
+			  first, position of values[0] in the input
+			  numOfValues, number of elements
+			  sums, output, _numOfHidden numbers
+	Return	: None
+*/
+void FeedForward::embed(const double *values, int first, int numOfValues, double *sums) const
+{
+	int i, j;
+	const double *w;
+
+	for (i=0, w=iWeights+first; i<_numOfHidden; ++i, w+=_numOfInput)
+	{
+		sums[i] = 0;
+		for (j=0; j<numOfValues; ++j)
+			sums[i] += values[j]*w[j];
+	}
+}
+
+/*
+	Function: evaluateSums()
+	Desc	: calculate network's output from the weighted sums of an input
+	Para	: sums, the weighted sum of the whole input of each hidden unit, bias excluded
+	Return	: double
+*/
+double FeedForward::evaluateSums(const double *sums) const
+{
+	int i;
+	double outputSum;
+
+	outputSum=0;
+	for (i=0; i<_numOfHidden; ++i)
+		outputSum += calcHiddenTrans(hBias[i] + sums[i]) * hWeights[i];
+	outputSum += *oBias;
+
+	return calcOutputTrans(outputSum);
+}
+
+int FeedForward::numOfHidden() const
+{
+	return _numOfHidden;
+}
+
+/*
+	Function: clearGradient()
+	Desc	: set the gradient descent variables to 0
+	Para	: None
+	Return	: None
+*/
+void FeedForward::clearGradient()
+{
+	fill(gradients, gradients + numOfPara, 0.0);
 }
 
 /*
@@ -535,28 +658,13 @@ void FeedForward::clearGradient()
 	Desc	: initialize some variable with vector<double> type
 	Para	: None
 	Return	: None
+	Note	: the gradient is in the block allocated by layout()
 */
 void FeedForward::initGradient()
 {	
-	vector<double> w;
-
-	// clear vector variable
-	iWGradient.clear();
-	hBGradient.clear();
-	hWGradient.clear();
-	hInput.clear();
-	hOutput.clear();
-
-	// gradient variable
-	w.insert(w.end(), _numOfInput, 0.0);
-	iWGradient.insert(iWGradient.end(), _numOfHidden, w);
-
-	hBGradient.insert(hBGradient.end(), _numOfHidden, 0.0);
-	hWGradient.insert(hWGradient.end(), _numOfHidden, 0.0);
-	
 	// input/output variable
-	hInput.insert(hInput.end(), _numOfHidden, 0.0);
-	hOutput.insert(hOutput.end(), _numOfHidden, 0.0);
+	hInput.assign(_numOfHidden, 0.0);
+	hOutput.assign(_numOfHidden, 0.0);
 }
 
 void FeedForward::Test(vector<double> &input, double output)
@@ -590,40 +698,34 @@ void FeedForward::Test(vector<double> &input, double output)
 void FeedForward::randomInit()
 {
 	int i, j;
-	vector<double> w;
-
-	iWeights.clear();
-	hBias.clear();
-	hWeights.clear();
+	double *w;
 
 double rnd, norm;
 	for (i=0; i<_numOfHidden; ++i)
 	{
 		
 		norm = 0;
-		w.clear();
+		w = iWeights + i*_numOfInput;
 		// weight factor on the link between input unit and hidden unit
 		for (j=0; j<_numOfInput; ++j)
 		{
 			rnd = r.nextDouble(-1,1);
 			norm += rnd*rnd;	// calculate the normalization factor of current hidden unit
 
-			w.push_back(rnd);
+			w[j] = rnd;
 		}
 
 		// adjust the magnitude of weights
 		for (j=0; j<_numOfInput; ++j)
 			w[j]/=sqrt(norm);
 
-		iWeights.push_back(w);
-
 		// bias for hidden unit
-		hBias.push_back(r.nextDouble(-1,1));
+		hBias[i] = r.nextDouble(-1,1);
 
 		// weight factor on the link between hidden unit and output unit
-		hWeights.push_back(r.nextDouble(-1,1));
+		hWeights[i] = r.nextDouble(-1,1);
 	}
 
 	// bias for the output unit
-	oBias = r.nextDouble(-1,1);
+	*oBias = r.nextDouble(-1,1);
 }
\ No newline at end of file
@@ -16,36 +16,35 @@ class FeedForward : public NeuralNetwork
 	// active region of hidden unit's transfer function
 	vector<double> activeRegion;
 
+	// views of the parameter blocks of NeuralNetwork and of the gradient blocks, which are laid out in this order
+
 	// the weight factors and their gradient on the link between input unit and hidden unit
 	// M*N, M represents number of hidden unit, N represents number of input element,
-	// each row represent all the weight factor for one single hidden unit
-	vector<vector<double> > iWeights, iWGradient;
+	// stored row by row, each row represent all the weight factor for one single hidden unit
+	double *iWeights, *iWGradient;
 	
 	// the bias and their gradient on each hidden unit
-	vector<double> hBias, hBGradient;
+	double *hBias, *hBGradient;
 
 	// the weight factors and their gradient on the link between hidden unit and output unit
-	vector<double> hWeights, hWGradient;
+	double *hWeights, *hWGradient;
 	
 	// the bias and its gradient on the output unit
-	double oBias, oBGradient;
+	double *oBias, *oBGradient;
 
 	/***************** Overwrite Virtual Function ****************************/
 	// Transfer function on hidden unit
-	double calcHiddenTrans(double x);
+	double calcHiddenTrans(double x) const;
 	
 	// calculate derivative of hidden unit i
 	double calcHiddenDerivative(int i);
 
 	// Transfer function on output unit
-	double calcOutputTrans(double x);
+	double calcOutputTrans(double x) const;
 
 	// calculate gradient upon weight and bias
 	double calcGradientDescent(vector<vector<double> > &inputs, vector<double> &expectedOutputs);
 
-	// store address of weights and their gradient into a vector
-	void getWeights();
-
 	// save network
 	void save(fstream &fout);
 
@@ -53,6 +52,9 @@ class FeedForward : public NeuralNetwork
 	// clear gradient descent
 	void clearGradient();
 
+	// allocate the parameter blocks for the current numbers of input elements and hidden units, and set the views
+	void layout();
+
 	// initialization vector variable
 	void initGradient();
 
@@ -71,6 +73,17 @@ class FeedForward : public NeuralNetwork
 	void randomInit();
 
 public:
+	// the hidden units' input for the input of a parent state, its successors' inputs only differ from it 
+	// in a few elements and are evaluated from it
+	struct Activation
+	{
+		vector<double> input;
+		vector<double> hidden;				// input of each hidden unit, bias included
+		long version;						// version of the weights it was computed with, -1 when none
+
+		Activation(void) : version(-1) {}
+	};
+
 	FeedForward(void);
 	~FeedForward(void);
 
@@ -83,6 +96,27 @@ public:
 	// calculate output of neural network
 	double calcOutput(vector<double> &x);
 
+	// calculate output of neural network without keeping the hidden units' input/output, can be called concurrently
+	double evaluate(const vector<double> &x) const;
+
+	// calculate outputs of a batch of inputs, x holds numOfRows inputs one after another
+	void evaluate(const double *x, int numOfRows, double *outputs) const;
+
+	// keep an input and the input of each hidden unit for it
+	void activate(const double *x, Activation& a) const;
+
+	// calculate the output of an input which only differs from the input of a at the changed positions
+	double evaluate(const Activation& a, const double *x, const int *changed, int numOfChanged) const;
+
+	// weighted sum of the input elements first to first+numOfValues-1 taking the given values, for each hidden unit
+	void embed(const double *values, int first, int numOfValues, double *sums) const;
+
+	// calculate network's output from the weighted sum of the whole input of each hidden unit, bias excluded
+	double evaluateSums(const double *sums) const;
+
+	// number of hidden units
+	int numOfHidden() const;
+
 	// save network
 	void save(string fileName);
 };
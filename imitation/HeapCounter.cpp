@@ -0,0 +1,67 @@
+#include "HeapCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static atomic<long> numOfAllocations(0), numOfBytes(0);
+
+bool HeapCounter::enabled()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+long HeapCounter::allocations()
+{
+	return numOfAllocations.load(memory_order_relaxed);
+}
+
+long HeapCounter::bytes()
+{
+	return numOfBytes.load(memory_order_relaxed);
+}
+
+void HeapCounter::reset()
+{
+	numOfAllocations.store(0, memory_order_relaxed);
+	numOfBytes.store(0, memory_order_relaxed);
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+/*
+	Function: operator new
+	Desc.	: count the allocation and take the memory from malloc
+	Para.	: size, number of bytes
+	Return	: the memory, bad_alloc is thrown when there is none
+	Note	: the array and nothrow forms of the standard library call this one, operator delete 
+			  gives the memory back to free
+*/
+void *operator new(size_t size)
+{
+	void *p = malloc(size == 0 ? 1 : size);
+
+	if (p == 0)
+		throw bad_alloc();
+
+	numOfAllocations.fetch_add(1, memory_order_relaxed);
+	numOfBytes.fetch_add((long)size, memory_order_relaxed);
+
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	free(p);
+}
+
+#endif
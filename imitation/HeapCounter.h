@@ -0,0 +1,25 @@
+#ifndef HEAPCOUNTER_H
+#define HEAPCOUNTER_H
+
+using namespace std;
+
+/*
+	Counts the allocations made through the global operator new. HeapCounter.cpp only replaces it
+	when COUNT_ALLOCATIONS is defined, as in the imitation_count target of the Makefile, so the
+	program normally runs on the stock allocator and the counters stay at zero. When they are on,
+	the debug output of the training reports the heap allocations of each round.
+*/
+class HeapCounter
+{
+public:
+	// whether this build counts the allocations
+	static bool enabled();
+
+	// number of allocations and bytes allocated since the last reset
+	static long allocations();
+	static long bytes();
+
+	static void reset();
+};
+
+#endif
@@ -4,6 +4,12 @@ Imitation::Imitation(int numOfHidden, bool debugMode)
 {
 	numOfHiddenUnits = numOfHidden;
 	DEBUG_MODE = debugMode;
+	searchType = ASTAR;
+	beamWidth = DEFAULT_BEAM_WIDTH;
+	timeBudget = DEFAULT_TIME_BUDGET;
+	parentEvaluation = false;
+	tableEvaluation = false;
+	seed = 0;
 
 	// load primitive action
 	loadAction("actions.txt");
@@ -55,6 +61,9 @@ Imitation::Imitation(int numOfHidden, bool debugMode)
 
 Imitation::~Imitation(void) 
 {
+	for (size_t i=0; i<taskContexts.size(); ++i)
+		delete taskContexts[i];
+
 	fout_update.close();
 	fout_policy.close();
 	fout_err.close();
@@ -73,26 +82,235 @@ Imitation::~Imitation(void)
 					* EXPLOITATION: call calcOutput() and return the result.
 					* EXPLORATION: geneerate new cost based on its mean (the result from calcRBF()) and standard deviation.
 	Return	: The distance between observed state and internal state
+	Note	: the network is evaluated from the embedding table of the context when tableEvaluation is on
 */
-double Imitation::calcDistance(State extState, State intState, int modelState)
+double Imitation::calcDistance(SearchContext& c, const State& extState, const State& intState, int modelState)
 {
-	double mean, rnd;
-	vector<double> input;
+	double mean;
 
-	// convert state pair into numeric representation
-	input = convert(extState, intState);
+	if (tableEvaluation)
+	{
+		// the table follows the encoders, which follow the problem
+		c.embeddings.check(nn, c.extEncoder, c.intEncoder);
 
-	// calculate distance
-	mean = calcDistance(input);
+		// calculate distance, set it zero when it is negative
+		mean = c.embeddings.evaluate(extState, intState);
+		if (mean < 0)
+			mean = 0;
+	}
+	else
+		mean = calcDistance(convert(c, extState, intState));
 
 	// EXPLOITATION phase, directly return the result from NN
 	if (modelState == EXPLOITATION)
 		return mean;
 
 	// EXPLORATION phase, generate new cost base on current mean and standard deviation
+	return randomDistance(c, mean);
+}
+
+/*
+	Function: calcDistance()
+	Desc.	: calculate the distance between an internal state and its observed state through the graph of the current search
+	Para.	: intState, an internal state
+			  modelState, EXPLORATION or EXPLOITATION
+	Return	: distance
+	Note	: the network input of a vertex is computed once, and its output again only after the weights changed.
+			  Without a graph the distance is kept in the distance cache of the context
+*/
+double Imitation::calcDistance(SearchContext& c, const InternalState& intState, int modelState)
+{
+	double mean;
+
+	if (c.currGraph == 0)
+	{
+		c.distanceCache.check(nn.getVersion());
+		if (!c.distanceCache.find(intState, mean))
+		{
+			mean = calcDistance(c, c.currObservedStates[intState.extStateNum], intState.state, EXPLOITATION);
+			c.distanceCache.insert(intState, mean);
+		}
+
+		if (modelState == EXPLOITATION)
+			return mean;
+
+		return randomDistance(c, mean);
+	}
+
+	SearchGraph::Vertex& v = c.currGraph->vertex(intState);
+	if (v.version != nn.getVersion())
+	{
+		if (v.input.empty())
+			v.input = convert(c, c.currObservedStates[intState.extStateNum], intState.state);
+
+		v.mean = calcDistance(v.input);
+		v.version = nn.getVersion();
+	}
+
+	if (modelState == EXPLOITATION)
+		return v.mean;
+
+	return randomDistance(c, v.mean);
+}
+
+/*
+	Function: calcDistances()
+	Desc.	: calculate the distances of a batch of internal states to their observed states (EXPLOITATION)
+	Para.	: states, internal states
+			  distances, the distance of each state
+			  parent, the state whose successors the states are, 0 when they aren't or parentEvaluation is off
+	Return	: None
+	Note	: only the states whose distance isn't in the graph of the current search or, without a graph, 
+			  in the distance cache are evaluated. Without a parent the inputs of the graph are put in one 
+			  matrix and go through the network together, or through the embedding table when tableEvaluation
+			  is on and there is no graph. The inputs of successors only differ from their parent's in a few
+			  features, so with parentEvaluation the network keeps the hidden units' input of the parent and
+			  each successor is evaluated from it
+*/
+void Imitation::calcDistances(SearchContext& c, const vector<const InternalState *>& states, vector<double>& distances, const InternalState *parent)
+{
+	size_t i, j, k, n;
+	long version = nn.getVersion();
+	bool parentEncoded = false;
+
+	distances.resize(states.size());
+	c.batchVertices.resize(states.size());
+	c.batchInputs.clear();
+	c.batchRows.clear();
+	c.batchChanges.clear();
+	c.batchChangeStarts.assign(1, 0);
+
+	if (!parentEvaluation)
+		parent = 0;
+
+	if (c.currGraph == 0)
+		c.distanceCache.check(version);
+
+	// encode the states which need the network
+	for (i=0; i<states.size(); ++i)
+	{
+		if (c.currGraph != 0)
+		{
+			SearchGraph::Vertex& v = c.currGraph->vertex(*states[i]);
+			c.batchVertices[i] = &v;
+			if (v.version == version)
+			{
+				distances[i] = v.mean;
+				continue;
+			}
+
+			if (v.input.empty())
+				v.input = convert(c, c.currObservedStates[states[i]->extStateNum], states[i]->state);
+			c.batchInputs.insert(c.batchInputs.end(), v.input.begin(), v.input.end());
+
+			if (parent != 0)
+			{
+				if (!parentEncoded)
+				{
+					activate(c, *parent);
+					parentEncoded = true;
+				}
+
+				for (j=0; j<v.input.size(); ++j)
+					if (v.input[j] != c.parentFeatures[j])
+						c.batchChanges.push_back((int)j);
+			}
+		}
+		else
+		{
+			if (c.distanceCache.find(*states[i], distances[i]))
+				continue;
+
+			// encoded in place at the end of the batch, unless the states go through the embedding table
+			if (parent != 0 || !tableEvaluation)
+			{
+				n = numOfFeatures(c);
+				k = c.batchInputs.size();
+				c.batchInputs.resize(k + n);
+				convert(c, c.currObservedStates[states[i]->extStateNum], states[i]->state, &c.batchInputs[k]);
+			}
+
+			if (parent != 0)
+			{
+				if (!parentEncoded)
+				{
+					activate(c, *parent);
+					parentEncoded = true;
+				}
+
+				// encoded in full, the positions which differ from the parent's input are found by comparing them
+				for (j=0; j<n; ++j)
+					if (c.batchInputs[k+j] != c.parentFeatures[j])
+						c.batchChanges.push_back((int)j);
+			}
+		}
+		c.batchRows.push_back(i);
+		c.batchChangeStarts.push_back(c.batchChanges.size());
+	}
+
+	if (c.batchRows.empty())
+		return;
+
+	c.batchOutputs.resize(c.batchRows.size());
+	if (parent == 0 && c.currGraph == 0 && tableEvaluation)
+	{
+		c.embeddings.check(nn, c.extEncoder, c.intEncoder);
+		for (k=0; k<c.batchRows.size(); ++k)
+			c.batchOutputs[k] = c.embeddings.evaluate(c.currObservedStates[states[c.batchRows[k]]->extStateNum], states[c.batchRows[k]]->state);
+	}
+	else if (parent == 0)
+		nn.evaluate(&c.batchInputs[0], (int)c.batchRows.size(), &c.batchOutputs[0]);
+	else
+	{
+		n = c.batchInputs.size() / c.batchRows.size();
+		for (k=0; k<c.batchRows.size(); ++k)
+			c.batchOutputs[k] = nn.evaluate(c.parentActivation, &c.batchInputs[k*n], c.batchChanges.data() + c.batchChangeStarts[k], 
+				(int)(c.batchChangeStarts[k+1] - c.batchChangeStarts[k]));
+	}
+
+	for (k=0; k<c.batchRows.size(); ++k)
+	{
+		i = c.batchRows[k];
+
+		// set it zero when it is negative
+		distances[i] = c.batchOutputs[k] < 0 ? 0 : c.batchOutputs[k];
+
+		if (c.currGraph != 0)
+		{
+			c.batchVertices[i]->mean = distances[i];
+			c.batchVertices[i]->version = version;
+		}
+		else
+			c.distanceCache.insert(*states[i], distances[i]);
+	}
+}
+
+/*
+	Function: activate()
+	Desc.	: encode the state whose successors are evaluated and keep the hidden units' input of the network for it
+	Para.	: parent, the state
+	Return	: None
+*/
+void Imitation::activate(SearchContext& c, const InternalState& parent)
+{
+	c.parentFeatures.resize(numOfFeatures(c));
+	convert(c, c.currObservedStates[parent.extStateNum], parent.state, &c.parentFeatures[0]);
+	nn.activate(&c.parentFeatures[0], c.parentActivation);
+}
+
+/*
+	Function: randomDistance()
+	Desc.	: generate a distance based on the given mean and current standard deviation
+	Para.	: mean, the distance given by the network
+	Return	: a non-negative distance
+*/
+double Imitation::randomDistance(SearchContext& c, double mean)
+{
+	double rnd;
+
 	while (true)
 	{
-		rnd = r.nextGaussian(mean, stdDeviation);
+		rnd = c.r.nextGaussian(mean, stdDeviation);
 		if (rnd>=0)
 			return rnd;
 	}
@@ -104,11 +322,11 @@ double Imitation::calcDistance(State extState, State intState, int modelState)
 	Para.	: input, numeric representation for Observed and internal state
 	Return	: The distance between observed state and internal state
 */
-double Imitation::calcDistance(vector<double> input)
+double Imitation::calcDistance(const vector<double>& input)
 {
 	double output;
 
-	output = nn.calcOutput(input);
+	output = nn.evaluate(input);
 	// set it zero when it is negative
 	if (output < 0)
 		output = 0;
@@ -145,95 +363,58 @@ void Imitation::loadAction(const string fileName)
 			  intState, internal state
 	Return	: numeric representation of the observed state and internal state
 */
-vector<double> Imitation::convert(State extState, State intState)
+vector<double> Imitation::convert(SearchContext& c, const State& extState, const State& intState)
 {
-	vector<double> v1, v2;
-
-	// convert observed state
-	v1 = convert(extState, false);
-
-	// convert internal state
-	v2 = convert(intState, true);
+	vector<double> v(numOfFeatures(c));
 
-	// append internal representation at the end
-	v1.insert(v1.end(), v2.begin(), v2.end());
+	convert(c, extState, intState, &v[0]);
 
-	return v1;
+	return v;
 }
 
-/*
+/* 
 	Function: convert()
-	Desc	: Given a state and return its numeric representation which encoding both relationship and objects' attributes
-	Para	: state, a state representation
-			  internal, whether the state is internal represetnation or not
-	Return	: the numeric representation
+	Desc.	: write the numeric representation of the observed state and the internal state into a buffer
+	Para.	: extState, observed state
+			  intState, internal state
+			  features, output, numOfFeatures() numbers, the observed state first
+	Return	: None
 */
-vector<double> Imitation::convert(State state, bool internal)
+void Imitation::convert(SearchContext& c, const State& extState, const State& intState, double *features)
 {
-	size_t i;
-	vector<Relation>::const_iterator iter;
-	vector<double> result;
-	
-	string actor;
-	vector<Object> o;				// objects
-	map<string,double> m;			// map between string representation and numeric representation
-	
-	if (internal)
-	{
-		//actor = mapto<string>(DEMO, mMap);
-		actor = mMap[DEMO];			// TEST ON 12/22/05
-		o = intObjects;				// internal object representation
-		m = intNumMap;
-	}
-	else
-	{
-		actor = DEMO;
-		o = currObservedObjects;	// observed object representation
-		m = extNumMap;
-	}
-	
-	// assume each demonstration has a fully object definition, even if in some case just use part of it.
-	// Object name isn't encoded in the input, but its attributes, color and texture
-	for (i=0; i<o.size(); ++i)
-	{
-		// check if the same entry with "Demo objA" exists in the observed/internal state
-		iter = state.findPattern(Relation("?", actor, o[i].name));
-		if (iter == state.end())
-			// not exists in the state, insert four 0 (relation, Demo and two attributes)
-			result.insert(result.end(),4, 0);
-		else
-		{
-			// relation
-			result.push_back(m[iter->relation]);
-			// demonstrator or imitator
-			result.push_back(m[iter->objA]);
-
-			// object attributes
-			result.push_back(m[o[i].color]);
-			result.push_back(m[o[i].texture]);
-		}
-	}
+	c.extEncoder.encode(extState, features);
+	c.intEncoder.encode(intState, features + c.extEncoder.size());
+}
 
-	 // There is special case for gripper, check if an object on the gripper
-	iter = state.findPattern(Relation("ON", "Gripper", "?"));
-	result.push_back(m["ON"]);
-	result.push_back(m["Gripper"]);
-	
-	if (iter->objB == "NULL")
-		// nothing on gripper, two 0s for attribute
-		result.insert(result.end(),2, 0);		// NULL or 0??
-	else
-	{
-		// find the object attributes
-		vector<Object>::const_iterator objIter = find_if(o.begin(), o.end(), sameName<Object>(iter->objB));
-		result.push_back(m[objIter->color]);
-		result.push_back(m[objIter->texture]);
-	}
+/*
+	Function: numOfFeatures()
+	Desc.	: number of numbers in the representation of a state pair, four for each object and for the gripper
+	Para.	: None
+	Return	: int
+	Note	: the encoders of the context are built for its problem by checkProblem()
+*/
+int Imitation::numOfFeatures(SearchContext& c)
+{
+	return c.extEncoder.size() + c.intEncoder.size();
+}
 
-	return result;
+/*
+	Function: checkProblem()
+	Desc.	: build the encoders of a context again and forget its cached distances when its problem has changed
+	Para.	: None
+	Return	: None
+	Note	: it compares the whole problem, so it is done when the problem is set and when a search begins, the
+			  distance calculations only check the version of the network
+*/
+void Imitation::checkProblem(SearchContext& c)
+{
+	c.extEncoder.check(c.currObservedObjects, extNumMap, SYM_DEMO);
+	c.intEncoder.check(c.intObjects, intNumMap, mapto(SYM_DEMO, mMap));
+	c.distanceCache.check(c.currObservedObjects, c.currObservedStates, c.intObjects);
 }
+
 	
-int Imitation::search(vector<vector<double> > &all , vector<double> single)
+int Imitation::search(const vector<vector<double> > &all, const vector<double>& single)
 {
 	size_t i;
 	for (i=0; i<all.size(); ++i)
@@ -261,7 +442,7 @@ void Imitation::loadMapping(const string fileName)
 	{
 		fin >> extRep;
 		fin >> intRep;
-		mMap.insert(make_pair(extRep, intRep));
+		mMap.insert(make_pair(Symbol(extRep), Symbol(intRep)));
 	}
 	fin.close();
 }
@@ -273,13 +454,13 @@ void Imitation::loadMapping(const string fileName)
 			  numMap, variable used to store the mapping
 	Return	: None
 */
-map<string, double> Imitation::loadNumMapping(const string fileName)
+map<Symbol, double> Imitation::loadNumMapping(const string fileName)
 {
 	int i, num;
 	double numRep;
 	string extRep;
 
-	map<string, double> numMap;
+	map<Symbol, double> numMap;
 
 	fstream fin;
 
@@ -290,7 +471,7 @@ map<string, double> Imitation::loadNumMapping(const string fileName)
 	{
 		fin >> extRep;
 		fin >> numRep;
-		numMap.insert(make_pair(extRep, numRep));
+		numMap.insert(make_pair(Symbol(extRep), numRep));
 	}
 	fin.close();
 
@@ -345,14 +526,14 @@ void Imitation::generateSamples()
 	for (i=0; i<newDemos.size(); ++i)
 	{
 		// set observed model
-		setCurrentObservedModel(newDemos[i].objects, newDemos[i].states);
+		setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states);
 		for (j=0; j<newDemos[i].states.size(); ++j)
 		{
 			// for each state, make a observed/internal pair
 			s1 = newDemos[i].states[j];
 			s2 = mapping(s1,mMap);
 
-			samples.push_back(convert(s1,s2));
+			samples.push_back(convert(ctx, s1,s2));
 		}
 	}
 }
@@ -364,17 +545,19 @@ void Imitation::generateSamples()
 			  observedStates, the sequence of states in current demonstration
 	Return	: None
 */
-void Imitation::setCurrentObservedModel(const vector<Object> &observedObjects, const vector<State> &observedStates)
+void Imitation::setCurrentObservedModel(SearchContext& c, const vector<Object> &observedObjects, const vector<State> &observedStates)
 {
 	size_t i;
 
-	currObservedObjects = observedObjects;
-	currObservedStates = observedStates;
+	c.currObservedObjects = observedObjects;
+	c.currObservedStates = observedStates;
 
 	// set internal objects
-	intObjects.clear();
+	c.intObjects.clear();
 	for (i=0; i<observedObjects.size(); ++i)
-		intObjects.push_back(mapping(observedObjects[i], mMap));
+		c.intObjects.push_back(mapping(observedObjects[i], mMap));
+
+	checkProblem(c);
 }
 
 /*
@@ -385,11 +568,13 @@ void Imitation::setCurrentObservedModel(const vector<Object> &observedObjects, c
 			  internalObjects, all the objects in the imitation environment
 	Return	: None
 */
-void Imitation::setCurrentObservedModel(const vector<Object> &observedObjects, const vector<State> &observedStates, const vector<Object> internalObjects)
+void Imitation::setCurrentObservedModel(SearchContext& c, const vector<Object> &observedObjects, const vector<State> &observedStates, const vector<Object> internalObjects)
 {
-	currObservedObjects = observedObjects;
-	currObservedStates = observedStates;
-	intObjects = internalObjects;
+	c.currObservedObjects = observedObjects;
+	c.currObservedStates = observedStates;
+	c.intObjects = internalObjects;
+
+	checkProblem(c);
 }
 
 /*
@@ -397,6 +582,7 @@ void Imitation::setCurrentObservedModel(const vector<Object> &observedObjects, c
 	Desc	: Given a demonstration, see if the imitator can successully imitate
 	Para	: fileName, the name of the file where the demonstration is stored.
 	Return	: None
+	Note	: with BEAM each problem is searched with full A* too, and the reward lost is reported
 */
 void Imitation::testing(int modelState)
 {
@@ -427,6 +613,9 @@ void Imitation::testing(int modelState)
 			outputFile = "test_2.txt";
 	}
 	fout.open(outputFile.c_str(), ios::out);
+
+	totBeamLoss = 0;
+	numOfBeamTests = 0;
 	
 	test_1(modelState, fout);
 	test_N(modelState, fout);
@@ -436,8 +625,39 @@ void Imitation::testing(int modelState)
 	loadImitObjects("TESTING_IMIT.txt");
 	test_new(modelState, fout);
 
+	if (searchType == BEAM && numOfBeamTests > 0)
+	{
+		cout << "beam width " << beamWidth << " average reward loss: " << totBeamLoss/numOfBeamTests << endl;
+		fout << "beam width " << beamWidth << " average reward loss: " << totBeamLoss/numOfBeamTests << endl;
+	}
+
 	fout.close();
 }
+
+/*
+	Function: compareWithAStar()
+	Desc	: search the current problem again with full A* and report the reward lost by the beam search
+	Para	: modelState, the model state of the beam search
+			  reward, the reward of the beam search's policy, its tree is ctx.currAStarTree
+			  numOfDemo, the demonstration number
+			  fout, output stream
+	Return	: None
+*/
+void Imitation::compareWithAStar(int modelState, double reward, int numOfDemo, fstream &fout)
+{
+	psType policySibling;
+	double fullReward;
+
+	// the levels are only bounded by BEAM
+	policySibling = AStarSearch(ctx, modelState, ctx.newAStarTree, ASTAR);
+
+	fullReward = calcReward(ctx, policySibling.first, numOfDemo);
+	totBeamLoss += fullReward - reward;
+	++numOfBeamTests;
+
+	fout << "beam width " << beamWidth << " reward: " << reward << " A* reward: " << fullReward << " loss: " << fullReward - reward <<
+		" nodes: " << ctx.currAStarTree.size() << " A* nodes: " << ctx.newAStarTree.size() << endl;
+}
 void Imitation::test_new(int modelState, fstream &fout)
 {
 	double reward;
@@ -448,37 +668,41 @@ void Imitation::test_new(int modelState, fstream &fout)
 	for (int i=0; i<newDemos.size(); ++i)
 	{
 		// set current observed model
-		setCurrentObservedModel(newDemos[i].objects, newDemos[i].states, imitObjects[i]);
+		setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states, imitObjects[i]);
 
 		// the demo is same as training, but the objects are different
 		//switch (newDemos[i].num)
 		//{
 		//	case 0:		// trash cleaning
-		//		currObservedObjects[0].color = "GREEN";
-		//		currObservedObjects[0].texture = "PAPER";
+		//		ctx.currObservedObjects[0].color = "GREEN";
+		//		ctx.currObservedObjects[0].texture = "PAPER";
 		//		break;
 		//	case 1:		// toy collection
-		//		currObservedObjects[0].color = "BLUE";
-		//		currObservedObjects[0].texture = "PLASTIC";
+		//		ctx.currObservedObjects[0].color = "BLUE";
+		//		ctx.currObservedObjects[0].texture = "PLASTIC";
 		//		break;
 		//	case 301:
-		//		intObjects[0].texture = "STONE";
-		//		intObjects[1].texture = "METAL";
+		//		ctx.intObjects[0].texture = "STONE";
+		//		ctx.intObjects[1].texture = "METAL";
 		//}
 
 		// run the A* algorithm
-		policySibling = AStarSearch(modelState, currAStarTree);
+		policySibling = AStarSearch(ctx, modelState, ctx.currAStarTree);
 		
 		// calculate reward
-		reward = calcReward(policySibling.first, newDemos[i].num);
+		reward = calcReward(ctx, policySibling.first, newDemos[i].num);
 		//cout << "task " << i << " reward: " << reward << endl;		
 		cout << reward << " ";
 		fout << "task " << i << " reward: " << reward << endl;
+		if (searchType == BEAM)
+			compareWithAStar(modelState, reward, newDemos[i].num, fout);
+		else if (searchType == ANYTIME)
+			fout << "suboptimality bound: " << ctx.bound << endl;
 		
 		// output policy
-		printNodes(fout, policySibling.first);
+		printNodes(ctx, fout, policySibling.first);
 		fout << "sibling nodes: " << endl;
-		printNodes(fout, policySibling.second);
+		printNodes(ctx, fout, policySibling.second);
 	}
 	cout << endl;
 }
@@ -498,19 +722,23 @@ void Imitation::test_1(int modelState, fstream &fout)
 	for (i=0; i<newDemos.size(); ++i)
 	{
 		// load observed model
-		setCurrentObservedModel(newDemos[i].objects, newDemos[i].states);
+		setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states);
 				
 		// run the A* algorithm
-		policySibling = AStarSearch(modelState, currAStarTree);
+		policySibling = AStarSearch(ctx, modelState, ctx.currAStarTree);
 
 		// calculate reward
-		reward = calcReward(policySibling.first, newDemos[i].num);
+		reward = calcReward(ctx, policySibling.first, newDemos[i].num);
 		totReward += reward;
 
 		// output policy
 		cout << reward << " ";
 		fout << "task: " << i << " reward: " << reward << endl;
-		printNodes(fout, policySibling.first);
+		if (searchType == BEAM)
+			compareWithAStar(modelState, reward, newDemos[i].num, fout);
+		else if (searchType == ANYTIME)
+			fout << "suboptimality bound: " << ctx.bound << endl;
+		printNodes(ctx, fout, policySibling.first);
 	}
 
 	cout << totReward/newDemos.size() << " ";
@@ -535,23 +763,27 @@ void Imitation::test_N(int modelState, fstream &fout)
 		for (j=0; j<imitationEnv[newDemos[i].num].size(); j++)
 		{
 			// load observed model
-			setCurrentObservedModel(newDemos[i].objects, newDemos[i].states);
+			setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states);
 
-			changeImitationEnvironment(newDemos[i].num, j);
+			changeImitationEnvironment(ctx, newDemos[i].num, j);
 				
 			// run the A* algorithm
-			policySibling = AStarSearch(modelState, currAStarTree);
+			policySibling = AStarSearch(ctx, modelState, ctx.currAStarTree);
 
 			// calculate reward
-			reward = calcReward(policySibling.first, newDemos[i].num);
+			reward = calcReward(ctx, policySibling.first, newDemos[i].num);
 			totReward += reward;		
 
 			// output policy
 			cout << reward << " ";
 			fout << "task " << i << " reward: " << reward << endl;
-			printNodes(fout, policySibling.first);
+			if (searchType == BEAM)
+				compareWithAStar(modelState, reward, newDemos[i].num, fout);
+			else if (searchType == ANYTIME)
+				fout << "suboptimality bound: " << ctx.bound << endl;
+			printNodes(ctx, fout, policySibling.first);
 			fout << "sibling nodes: " << endl;
-			printNodes(fout, policySibling.second);
+			printNodes(ctx, fout, policySibling.second);
 		}
 	}
 	cout << totReward/nCount << " ";
@@ -589,17 +821,17 @@ void Imitation::generatePSFromNN()
 		for (j=0; j<imitationEnv[newDemos[i].num].size(); j++)
 		{
 			// load observed model
-			setCurrentObservedModel(newDemos[i].objects, newDemos[i].states);
+			setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states);
 
-			changeImitationEnvironment(newDemos[i].num, j);
+			changeImitationEnvironment(ctx, newDemos[i].num, j);
 					
 			// run the A* algorithm
-			policySibling = AStarSearch(EXPLOITATION, currAStarTree);
+			policySibling = AStarSearch(ctx, EXPLOITATION, ctx.currAStarTree);
 			im.policy = policySibling.first;
-			reward = calcReward(policySibling.first, newDemos[i].num);
+			reward = calcReward(ctx, policySibling.first, newDemos[i].num);
 			//im.policy[0].f =99;
 		
-			imits.push_back(InternalModel(intObjects, policySibling.first, policySibling.second, reward));
+			imits.push_back(InternalModel(ctx.intObjects, policySibling.first, policySibling.second, reward));
 		}
 		newImits.push_back(imits);
 	}
@@ -682,26 +914,27 @@ void Imitation::testAction(State& s, int iAction, string p1, string p2)
 	Function: getPolicy()
 	Desc.	: Generate policy starting from goal state
 	Para.	: lBackpropagate, whether the cost is backpropagated up or not
+			  last, the last node of the policy, the first node on the open list when it is 0
 	Return	: a sequnce of states generated by A* algorithm
 */
-psType Imitation::getPolicy(const tree<Node>& aStarTree, bool lBackpropagate)
+psType Imitation::getPolicy(SearchContext& c, const searchTree& aStarTree, bool lBackpropagate, treeNode *last)
 {
-	list<Node> policy, siblings;
+	vector<Node> policy, siblings;
 
-	tree<Node>::sibling_iterator sIter;
+	searchTree::sibling_iterator sIter;
 
 	// get the first node on the open list, which is the goal state
-	treeNode *pre = openList.front();
+	treeNode *pre = (last != 0) ? last : c.openList.front();
 	double childCost = pre->data.f;
 	while(pre != 0)
 	{
 		// except the root node, each policy node's f is updated by max(itself, min(itchildren))
 		if (lBackpropagate && pre->parent!=0 && childCost > pre->data.f)
-			policy.push_front(Node(pre->data.state, pre->data.level, pre->data.g, childCost - pre->data.g));
+			policy.push_back(Node(pre->data.state, pre->data.level, pre->data.g, childCost - pre->data.g));
 		else
 		{
 			childCost = pre->data.f;
-			policy.push_front(Node(pre->data.state, pre->data.level, pre->data.g, pre->data.h));
+			policy.push_back(Node(pre->data.state, pre->data.level, pre->data.g, pre->data.h));
 		}
 		
 		//find its sibling
@@ -709,32 +942,16 @@ psType Imitation::getPolicy(const tree<Node>& aStarTree, bool lBackpropagate)
 		{
 			for (sIter = aStarTree.begin(pre->parent); sIter != aStarTree.end(pre->parent); ++sIter)
 				if (*sIter != pre->data)
-					siblings.push_front(*sIter);
+					siblings.push_back(*sIter);
 		}
 		pre= pre->parent;
 	}
 
-	return make_pair(vector<Node>(policy.begin(), policy.end()), vector<Node>(siblings.begin(), siblings.end()));
-}
-
-/*
-	Function: addToList()
-	Desc.	: Add a node into a list, its position is based on state's cost
-	Para.	: tree, the state list which is sorted in ascent order on cost
-			  node, an internal state that is going to be add to the tree
-	Return	: None
-*/
-void Imitation::addToList(list<treeNode *> &target, treeNode *node)
-{
-	list<treeNode *>::iterator p;
-
-	for (p=target.begin(); p != target.end(); ++p) 
-		// compare the cost
-		if ((*p)->data.f > node->data.f)
-			break;
+	// they were collected from the goal up to the root
+	reverse(policy.begin(), policy.end());
+	reverse(siblings.begin(), siblings.end());
 
-	// insert new state
-	target.insert(p, node);
+	return make_pair(move(policy), move(siblings));
 }
 
 /*
@@ -824,15 +1041,15 @@ void Imitation::saveLearnedDemos()
 		for (j=0; j<newImits[i].size(); ++j)
 		{
 			// load observed model
-			setCurrentObservedModel(newDemos[i].objects, newDemos[i].states, newImits[i][j].objects);
+			setCurrentObservedModel(ctx, newDemos[i].objects, newDemos[i].states, newImits[i][j].objects);
 
 			// generate the current policy and calculate the reward
-			policySibling = AStarSearch(EXPLOITATION, currAStarTree);
-			newImits[i][j] = InternalModel(intObjects, policySibling.first, policySibling.second);
-			/*newImits[i][j] = AStarSearch(EXPLOITATION);*/
+			policySibling = AStarSearch(ctx, EXPLOITATION, ctx.currAStarTree);
+			newImits[i][j] = InternalModel(ctx.intObjects, policySibling.first, policySibling.second);
+			/*newImits[i][j] = AStarSearch(ctx, EXPLOITATION);*/
 			
 			// recalculate reward
-			newImits[i][j].reward = calcReward(newImits[i][j].policy, newDemos[i].num);
+			newImits[i][j].reward = calcReward(ctx, newImits[i][j].policy, newDemos[i].num);
 		
 			// imitation separator
 			fout << "#" << endl;
@@ -853,7 +1070,7 @@ void Imitation::saveLearnedDemos()
 			  numOfDemo, demonstration's number. default is -1 for single-action training
 	Return	: double, reward calculated
 */
-double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
+double Imitation::calcReward(SearchContext& c, vector<Node> &policy, int numOfDemo)
 {
 	int i, iAction;
 	double reward;
@@ -866,7 +1083,7 @@ double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
 	goalIter = policy.end();
 
 	// goal state in current observed states
-	goalState = mapping(currObservedStates[currObservedStates.size()-1], mMap);
+	goalState = mapping(c.currObservedStates[c.currObservedStates.size()-1], mMap);
 
 	// since the first state is the start state, no action will be taken, this state should be excluded from reward calculation
 	for (iter = policy.begin()+1; iter!=policy.end(); ++iter)
@@ -881,7 +1098,7 @@ double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
 			goalIter = iter;
 	}
 
-	if (currObservedStates.size() == 2)					// single action task
+	if (c.currObservedStates.size() == 2)					// single action task
 	{
 		if (goalIter != policy.end())
 			reward += 20;
@@ -900,7 +1117,7 @@ double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
 				reward += calcRewardForCleaning(state);
 				break;
 			case TOY_COLLECTION:
-				reward += calcRewardForCollection(state);
+				reward += calcRewardForCollection(c, state);
 				break;
 			case 301:
 				reward += calcRewardForDoubleDrop(state);
@@ -908,7 +1125,7 @@ double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
 			case FUTON_MATCH_1:
 			case FUTON_MATCH_2:
 			default:
-				reward += calcReward(state);
+				reward += calcReward(c, state);
 				break;
 		}
 	}
@@ -921,7 +1138,7 @@ double Imitation::calcReward(vector<Node> &policy, int numOfDemo)
 	Para.	: state, the state that either match the final observed state or the final internal state
 	Retur	: reward for this task
 */
-double Imitation::calcRewardForCleaning(State state)
+double Imitation::calcRewardForCleaning(const State& state)
 {
 	double reward = 0;
 	string s = state.toString();
@@ -942,7 +1159,7 @@ double Imitation::calcRewardForCleaning(State state)
 	return reward;
 }
 
-double Imitation::calcRewardForDoubleDrop(State state)
+double Imitation::calcRewardForDoubleDrop(const State& state)
 {
 	double reward = 0;
 	string s = state.toString();
@@ -966,13 +1183,13 @@ double Imitation::calcRewardForDoubleDrop(State state)
 	}
 	return reward;
 }
-double Imitation::calcReward(State state)
+double Imitation::calcReward(SearchContext& c, const State& state)
 {
 	size_t i;
 
 	double reward = 0;
-	for (i=0; i<currObservedStates.size(); ++i)
-		if (state == mapping(currObservedStates[i], mMap))
+	for (i=0; i<c.currObservedStates.size(); ++i)
+		if (state == mapping(c.currObservedStates[i], mMap))
 		{
 			reward = i*20;
 			break;
@@ -981,18 +1198,18 @@ double Imitation::calcReward(State state)
 	return reward;
 }
 
-double Imitation::calcRewardForCollection(State state)
+double Imitation::calcRewardForCollection(SearchContext& c, const State& state)
 {
 	double reward = 0;
 	string s = state.toString();
 
-	if (state == mapping(currObservedStates[currObservedStates.size()-1], mMap))
+	if (state == mapping(c.currObservedStates[c.currObservedStates.size()-1], mMap))
 		reward = 80;
 	else if (s.find("NEXT Imitator ToyCorner") != -1 && s.find("ON Gripper Toy") != -1)
 		reward = 60;
 	else if (s.find("ON Gripper Toy") != -1)
 		reward = 40;
-	else if (state.findPattern(Relation("NEXT", "Imitator", "Toy")) != state.end())
+	else if (state.findPattern(Relation(SYM_NEXT, SYM_IMITATOR, "Toy")) != state.end())
 		reward = 20;
 
 	return reward;
@@ -1011,238 +1228,927 @@ void Imitation::saveData(string fileName)
 
 	fout.open(fileName.c_str(), ios::out);
 
-	// total number of training data
-	fout << inputs.size() << " " << inputs[0].size() << endl;
-	for (i=0; i<inputs.size(); ++i)
+	// total number of training data
+	fout << inputs.size() << " " << inputs[0].size() << endl;
+	for (i=0; i<inputs.size(); ++i)
+	{
+		// inputs
+		for (j=0; j<inputs[i].size(); ++j)
+			fout << inputs[i][j] << " ";
+
+		// expected output
+		fout << expectedOutputs[i] << endl;
+	}
+	fout.close();
+}
+
+/*
+	Function: loadData()
+	Desc.	: load input/expected output from a file
+	Para.	: fileName, file Name
+	Return	: None
+*/
+void Imitation::loadData(string fileName)
+{	
+	int i, j, numOfSample, numOfInput;	
+	double val;
+
+	fstream fin;
+
+	vector<double> input;
+
+	fin.open(fileName.c_str(), ios::in);
+	// if the file does not exist, exit
+	if (!fin.is_open())
+	{
+		fin.close();
+		return;
+	}
+
+	inputs.clear();
+	expectedOutputs.clear();
+
+	// read total number of training data
+	fin >> numOfSample;
+	// # of input in each training data
+	fin >> numOfInput;
+	for (i=0; i<numOfSample; ++i)
+	{
+		input.clear();
+		for (j=0; j<numOfInput; ++j)
+		{
+			// input
+			fin >> val;
+			input.push_back(val);
+		}
+		inputs.push_back(input);
+
+		// expected output
+		fin >> val;
+		expectedOutputs.push_back(val);
+	}
+	fin.close();
+}
+
+/*
+	Function: AStarSearch
+	Desc.	: Using A* algorithm to find a policy
+	Para.	: modelState, EXPLORATION (policy exploration) or EXPLOITATION
+	Return	: a pair, which including policy and sibling generated by A* algorithm
+	Note	: the search algorithm is searchType
+*/
+psType Imitation::AStarSearch(SearchContext& c, int modelState, searchTree& aStarTree)
+{
+	return AStarSearch(c, modelState, aStarTree, searchType);
+}
+
+/*
+	Function: AStarSearch
+	Desc.	: Using A* algorithm to find a policy
+	Para.	: modelState, EXPLORATION (policy exploration) or EXPLOITATION
+			  search, the search algorithm, ASTAR, REPLAN, BEAM, ANYTIME, IDASTAR or LAYERED
+	Return	: a pair, which including policy and sibling generated by A* algorithm
+	Note	: with ANYTIME, the non-exploration searches are run by ARAStarSearch() within the time budget,
+			  with IDASTAR by IDAStarSearch() and with LAYERED by layeredSearch()
+*/
+psType Imitation::AStarSearch(SearchContext& c, int modelState, searchTree& aStarTree, int search)
+{
+	treeNode *currState, *expanded = 0;
+
+	psType policySiblings;
+
+	if (search == ANYTIME && modelState != EXPLORATION)
+		return ARAStarSearch(c, modelState, aStarTree, timeBudget, c.bound);
+	if (search == IDASTAR && modelState != EXPLORATION)
+		return IDAStarSearch(c, modelState, aStarTree);
+	if (search == LAYERED && modelState != EXPLORATION)
+		return layeredSearch(c, modelState, aStarTree);
+
+	beginSearch(c, modelState, aStarTree, 1, search);
+	
+	currState = c.openList.front();
+	// loop until the first state in open list correspond to the last observed state
+	while (!isGoalState(c, currState->data.state)) 
+	{
+		expandNode(c, modelState, aStarTree, currState);
+		expanded = currState;
+
+		// get next node on the open list
+		currState = c.openList.front();
+
+		// the beam search pruned all the ways on, the policy ends at the last expanded node
+		if (currState == 0)
+			break;
+	}
+
+	// get the policy and siblings
+	policySiblings = getPolicy(c, aStarTree, true, currState != 0 ? currState : expanded);
+
+	backpropagateHeuristicCost(aStarTree);
+
+	endSearch(c);
+
+	return policySiblings;
+}
+
+/*
+	Function: ARAStarSearch
+	Desc.	: anytime A* (ARA*), find a policy quickly with an inflated heuristic cost, then improve it while
+			  there is time left
+	Para.	: modelState, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  aStarTree, the A* tree
+			  budget, time budget in seconds
+			  bound, set to the suboptimality bound of the returned policy, its cost is at most bound times 
+			  the cost of the best policy (relative to calcHeuristicCost())
+	Return	: the best policy found and its siblings
+	Note	: the open list is ordered by g + weight*h. After each policy the weight is lowered and the search
+			  goes on with the same tree, so the nodes expanded earlier are not expanded again. A node reached
+			  by a cheaper path is put on the open list again with its subtree removed, as in AStarSearch().
+			  The first policy is always completed, even when it takes longer than the budget. When no goal state
+			  can be reached, the policy ends at the last expanded node
+*/
+psType Imitation::ARAStarSearch(SearchContext& c, int modelState, searchTree& aStarTree, double budget, double &bound)
+{
+	const chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(budget));
+
+	size_t i;
+	bool found = false;
+	double bestCost = 0, solutionWeight = ARA_INITIAL_WEIGHT, minCost;
+
+	treeNode *currState, *expanded = 0;
+	vector<treeNode *> openNodes;
+
+	psType policySiblings;
+
+	beginSearch(c, modelState, aStarTree, ARA_INITIAL_WEIGHT, ANYTIME);
+
+	while (true)
+	{
+		// search with the current weight until a goal state is the first on the open list
+		currState = c.openList.front();
+		while (currState != 0 && !isGoalState(c, currState->data.state))
+		{
+			if (found && chrono::steady_clock::now() >= deadline)
+				break;
+
+			expandNode(c, modelState, aStarTree, currState);
+			expanded = currState;
+			currState = c.openList.front();
+		}
+
+		if (currState == 0 || !isGoalState(c, currState->data.state))
+			break;
+
+		// keep the policy when it is better than the ones found with the higher weights
+		if (!found || currState->data.g < bestCost)
+		{
+			policySiblings = getPolicy(c, aStarTree, true, currState);
+			bestCost = currState->data.g;
+		}
+		found = true;
+		solutionWeight = c.weight;
+
+		if (c.weight <= 1 || chrono::steady_clock::now() >= deadline)
+			break;
+
+		// lower the weight and reorder the open list
+		c.weight = max(1.0, c.weight - ARA_WEIGHT_STEP);
+		c.openList.getNodes(openNodes);
+		for (i=0; i<openNodes.size(); ++i)
+			c.openList.update(openNodes[i], openNodes[i]->data.g + c.weight*openNodes[i]->data.h);
+	}
+
+	// the best policy can't be cheaper than the cheapest node left on the open list
+	bound = solutionWeight;
+	c.openList.getNodes(openNodes);
+	if (!openNodes.empty())
+	{
+		minCost = openNodes[0]->data.f;
+		for (i=1; i<openNodes.size(); ++i)
+			minCost = min(minCost, openNodes[i]->data.f);
+
+		if (minCost > 0)
+			bound = min(bound, max(1.0, bestCost/minCost));
+	}
+
+	// no goal state was reached, the policy ends at the last expanded node as with AStarSearch()
+	if (!found)
+		policySiblings = getPolicy(c, aStarTree, true, expanded);
+
+	backpropagateHeuristicCost(aStarTree);
+
+	endSearch(c);
+
+	return policySiblings;
+}
+
+/*
+	Function: IDAStarSearch
+	Desc.	: iterative deepening A*, depth-first searches bounded by a threshold on f, the threshold is raised
+			  to the smallest f beyond it until a goal state is reached
+	Para.	: modelState, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  aStarTree, set to the policy and the successors of its nodes, the part of the A* tree
+			  getPolicy() and printTree() look at
+	Return	: a pair, which including policy and sibling
+	Note	: only the current path and the successors of its nodes are kept, so the memory grows with the length 
+			  of the policy and not with the number of nodes searched. Nodes are expanded again in each pass, 
+			  the distances come from the distance cache
+*/
+psType Imitation::IDAStarSearch(SearchContext& c, int modelState, searchTree& aStarTree)
+{
+	size_t d, k;
+	bool found = false;
+	double threshold;
+
+	vector<Node> path;
+	vector<vector<Node> > levels;	// the successors of each node on the path when a goal state is found
+	vector<size_t> chosen;			// index of the next node on the path among them
+
+	searchTree::pre_order_iterator treeIter, parentIter;
+
+	psType policySiblings;
+
+	// the start node, same as the A* search
+	beginSearch(c, modelState, aStarTree, 1, IDASTAR);
+	path.push_back(aStarTree.begin().node->data);
+	aStarTree.clear();
+	c.openList.clear();
+	c.nodeTable.clear();
+
+	threshold = path[0].f;
+	while (!found)
+	{
+		threshold = boundedSearch(c, modelState, path, levels, chosen, threshold, found);
+
+		// no goal state can be reached
+		if (threshold == numeric_limits<double>::infinity())
+			break;
+	}
+
+	// build the policy and the successors of its nodes into the tree
+	treeIter = aStarTree.set_head(path[0]);
+	for (d=0; found && d<levels.size(); ++d)
+	{
+		parentIter = treeIter;
+		for (k=0; k<levels[d].size(); ++k)
+		{
+			if (k == chosen[d])
+				treeIter = aStarTree.append_child(parentIter, levels[d][k]);
+			else
+				aStarTree.append_child(parentIter, levels[d][k]);
+		}
+	}
+
+	// get the policy and siblings
+	policySiblings = getPolicy(c, aStarTree, true, treeIter.node);
+
+	backpropagateHeuristicCost(aStarTree);
+
+	endSearch(c);
+
+	return policySiblings;
+}
+
+/*
+	Function: boundedSearch
+	Desc.	: depth-first search below the last node of the path, the nodes whose f is beyond the threshold are not expanded
+	Para.	: modelState, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  path, the current path from the start node
+			  levels, chosen, set to the successors of each node on the path and the index of the next node on the
+			  path when a goal state is found
+			  threshold, the threshold on f
+			  found, set to true when a goal state is found, the path ends at it
+	Return	: the smallest f beyond the threshold, infinity when there is none
+*/
+double Imitation::boundedSearch(SearchContext& c, int modelState, vector<Node>& path, vector<vector<Node> >& levels, 
+	vector<size_t>& chosen, double threshold, bool& found)
+{
+	size_t d, k;
+	double f, next;
+
+	list<InternalState> successors;
+	list<InternalState>::iterator successorIter;
+	vector<Node> children;
+
+	const size_t depth = path.size()-1;
+
+	if (path[depth].f > threshold)
+		return path[depth].f;
+
+	if (isGoalState(c, path[depth].state))
+	{
+		found = true;
+		levels.resize(depth);
+		chosen.resize(depth);
+		return path[depth].f;
+	}
+
+	generateSuccessors(c, modelState, path[depth].state, successors);
+
+	for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+	{
+		// skip the states on the path, they would make a cycle
+		for (d=0; d<=depth; ++d)
+			if (path[d].state.extStateNum == successorIter->extStateNum && path[d].state.state == successorIter->state)
+				break;
+		if (d <= depth)
+			continue;
+
+		children.push_back(Node((*successorIter), path[depth].level + 1, path[depth].g + calcActionCost(successorIter->action) + successorIter->distance, 
+			calcHeuristicCost(c, (*successorIter))));
+	}
+
+	// the cheapest first, the others keep the order they are generated in
+	stable_sort(children.begin(), children.end(), [](const Node& a, const Node& b) { return a.f < b.f; });
+
+	next = numeric_limits<double>::infinity();
+	for (k=0; k<children.size(); ++k)
+	{
+		path.push_back(children[k]);
+		f = boundedSearch(c, modelState, path, levels, chosen, threshold, found);
+		if (found)
+		{
+			levels[depth] = children;
+			chosen[depth] = k;
+			return f;
+		}
+		path.pop_back();
+
+		next = min(next, f);
+	}
+
+	return next;
+}
+
+/*
+	Function: layeredSearch
+	Desc.	: find the cheapest policy one observed state after another. The extStateNum of a successor is the same
+			  as its parent's or the next one, so the states of each observed state (a layer) only depend on the 
+			  layers before it: the cheapest paths inside a layer are found with Dijkstra's algorithm, starting
+			  from the states the previous layer leads to, and the successors in the next layer are its starting states
+	Para.	: modelState, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  aStarTree, set to the policy and the successors of its nodes, the part of the A* tree
+			  getPolicy() and printTree() look at
+	Return	: a pair, which including policy and sibling
+	Note	: the policy is the cheapest one (g), the A* search orders the nodes by g+h. The layers are only
+			  searched up to the cost of a greedy policy
+*/
+psType Imitation::layeredSearch(SearchContext& c, int modelState, searchTree& aStarTree)
+{
+	size_t i;
+	int j, k, idx, goal;
+	double g, newCost, upper;
+	const int last = c.currObservedStates.size()-1;
+
+	vector<StateLayer> layers(last+1);
+	priority_queue<pair<double, int>, vector<pair<double, int> >, greater<pair<double, int> > > queue;
+
+	list<InternalState> successors;
+	list<InternalState>::iterator successorIter;
+	InternalState s;
+
+	vector<Node> path;
+	vector<vector<Node> > levels;
+	vector<size_t> chosen;
+
+	searchTree::pre_order_iterator treeIter, parentIter;
+
+	psType policySiblings;
+
+	// the start node, same as the A* search
+	beginSearch(c, modelState, aStarTree, 1, LAYERED);
+	Node start = aStarTree.begin().node->data;
+	aStarTree.clear();
+	c.openList.clear();
+	c.nodeTable.clear();
+
+	upper = greedyCost(c, modelState, start.state, start.g);
+	layers[start.state.extStateNum].relax(start.state, start.g, -1, -1);
+
+	for (k=start.state.extStateNum; k<last; ++k)
+	{
+		// Dijkstra inside the layer, starting from the states reached from the previous layer
+		for (i=0; i<layers[k].size(); ++i)
+			queue.push(make_pair(layers[k][i].g, (int)i));
+
+		while (!queue.empty())
+		{
+			g = queue.top().first;
+			idx = queue.top().second;
+			queue.pop();
+
+			if (layers[k][idx].expanded || g > layers[k][idx].g)
+				continue;
+			layers[k][idx].expanded = true;
+
+			s = layers[k][idx].state;
+			generateSuccessors(c, modelState, s, successors);
+			for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+			{
+				newCost = g + calcActionCost(successorIter->action) + successorIter->distance;
+
+				// it can't lead to a policy cheaper than the greedy one, staying on the same internal state
+				// to reach the next observed state costs nothing, so no cost is added for the layers left
+				if (newCost > upper)
+					continue;
+
+				if (successorIter->extStateNum == k)
+				{
+					if ((j = layers[k].relax(*successorIter, newCost, k, idx)) != -1)
+						queue.push(make_pair(newCost, j));
+				}
+				else
+					layers[k+1].relax(*successorIter, newCost, k, idx);
+			}
+		}
+	}
+
+	// the cheapest goal state, a goal state is not expanded further. When no goal state can be reached, the 
+	// policy ends at the cheapest state of the last layer reached and doesn't reach the goal, as the policy of
+	// an A* search whose open list runs out
+	for (k=last; layers[k].size() == 0; --k)
+		;
+	goal = -1;
+	for (i=0; i<layers[k].size(); ++i)
+		if (goal == -1 || layers[k][i].g < layers[k][goal].g)
+			goal = i;
+
+	// follow the cheapest path back to the start state
+	for (idx=goal; idx != -1; )
+	{
+		const StateLayer::Entry& e = layers[k][idx];
+		path.insert(path.begin(), Node(e.state, 0, e.g, calcHeuristicCost(c, e.state)));
+		k = e.parentLayer;
+		idx = e.parent;
+	}
+
+	// the successors of each node on the path, the siblings of the policy
+	levels.resize(path.size()-1);
+	chosen.resize(path.size()-1);
+	for (i=0; i+1<path.size(); ++i)
 	{
-		// inputs
-		for (j=0; j<inputs[i].size(); ++j)
-			fout << inputs[i][j] << " ";
+		path[i].level = i;
+		generateSuccessors(c, modelState, path[i].state, successors);
+		chosen[i] = (size_t)-1;
+		for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+		{
+			if (chosen[i] == (size_t)-1 && successorIter->action == path[i+1].state.action && 
+				successorIter->extStateNum == path[i+1].state.extStateNum && successorIter->state == path[i+1].state.state)
+			{
+				chosen[i] = levels[i].size();
+				path[i+1].state = *successorIter;
+				levels[i].push_back(path[i+1]);
+			}
+			else
+				levels[i].push_back(Node((*successorIter), i+1, path[i].g + calcActionCost(successorIter->action) + successorIter->distance, 
+					calcHeuristicCost(c, (*successorIter))));
+		}
 
-		// expected output
-		fout << expectedOutputs[i] << endl;
+		// the successors are generated again, so the next node is one of them. Should none of them match, the
+		// policy keeps the node the layers lead to
+		if (chosen[i] == (size_t)-1)
+		{
+			chosen[i] = levels[i].size();
+			levels[i].push_back(path[i+1]);
+		}
+		levels[i][chosen[i]].level = i+1;
 	}
-	fout.close();
+	path.back().level = path.size()-1;
+
+	// build the policy and the successors of its nodes into the tree
+	treeIter = aStarTree.set_head(path[0]);
+	for (i=0; i<levels.size(); ++i)
+	{
+		parentIter = treeIter;
+		for (j=0; j<(int)levels[i].size(); ++j)
+		{
+			if (j == (int)chosen[i])
+				treeIter = aStarTree.append_child(parentIter, levels[i][j]);
+			else
+				aStarTree.append_child(parentIter, levels[i][j]);
+		}
+	}
+
+	// get the policy and siblings
+	policySiblings = getPolicy(c, aStarTree, true, treeIter.node);
+
+	backpropagateHeuristicCost(aStarTree);
+
+	endSearch(c);
+
+	return policySiblings;
 }
 
 /*
-	Function: loadData()
-	Desc.	: load input/expected output from a file
-	Para.	: fileName, file Name
-	Return	: None
+	Function: greedyCost
+	Desc.	: cost of a greedy policy, which goes to the next observed state with the cheapest successor each time
+	Para.	: modelState, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  start, the start state
+			  g, cost of the start state
+	Return	: the cost, infinity when the greedy policy gets stuck
 */
-void Imitation::loadData(string fileName)
-{	
-	int i, j, numOfSample, numOfInput;	
-	double val;
-
-	fstream fin;
+double Imitation::greedyCost(SearchContext& c, int modelState, const InternalState& start, double g)
+{
+	double cost, bestCost;
+	const int last = c.currObservedStates.size()-1;
 
-	vector<double> input;
+	InternalState s = start, best;
+	list<InternalState> successors;
+	list<InternalState>::iterator successorIter;
 
-	fin.open(fileName.c_str(), ios::in);
-	// if the file does not exist, exit
-	if (!fin.is_open())
+	while (s.extStateNum < last)
 	{
-		fin.close();
-		return;
-	}
-
-	inputs.clear();
-	expectedOutputs.clear();
+		bestCost = numeric_limits<double>::infinity();
 
-	// read total number of training data
-	fin >> numOfSample;
-	// # of input in each training data
-	fin >> numOfInput;
-	for (i=0; i<numOfSample; ++i)
-	{
-		input.clear();
-		for (j=0; j<numOfInput; ++j)
+		generateSuccessors(c, modelState, s, successors);
+		for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
 		{
-			// input
-			fin >> val;
-			input.push_back(val);
+			cost = calcActionCost(successorIter->action) + successorIter->distance;
+			if (successorIter->extStateNum == s.extStateNum+1 && cost < bestCost)
+			{
+				bestCost = cost;
+				best = *successorIter;
+			}
 		}
-		inputs.push_back(input);
 
-		// expected output
-		fin >> val;
-		expectedOutputs.push_back(val);
+		if (bestCost == numeric_limits<double>::infinity())
+			return bestCost;
+
+		g += bestCost;
+		s = best;
 	}
-	fin.close();
+
+	return g;
 }
 
 /*
-	Function: AStarSearch
-	Desc.	: Using A* algorithm to find a policy
-	Para.	: modelState, EXPLORATION (policy exploration) or EXPLOITATION
-	Return	: a pair, which including policy and sibling generated by A* algorithm
+	Function: beginSearch
+	Desc.	: prepare a search, clear the open list, the node table and the A* tree and put the start state on them
+	Para.	: modelState, EXPLORATION, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  aStarTree, the A* tree
+			  weight, weight of the heuristic cost in the keys of the open list, 1 for A*
+			  search, the search algorithm, BEAM bounds the levels and REPLAN reuses the graph of the problem
+	Return	: None
 */
-psType Imitation::AStarSearch(int modelState, tree<Node>& aStarTree)
+void Imitation::beginSearch(SearchContext& c, int modelState, searchTree& aStarTree, double weight, int search)
 {
-	double newCost;
-	bool findSuccessor;
+	searchTree::pre_order_iterator treeIter;
 
-	tree<Node>::pre_order_iterator treeIter, parentIter;
+	// clear the open list and the node table
+	c.openList.clear();
+	c.nodeTable.clear();
+	aStarTree.clear();
 
-	// sequence of states selected by the internal model
-	list<InternalState> successors;
-	list<InternalState>::iterator successorIter;
+	// the encoders and the cached distances belong to the problem being searched
+	checkProblem(c);
 
-	treeNode *currState;
-	list<treeNode *>::iterator p;
+	// the nodes of the last search are all gone, its pool starts over
+	aStarTree.get_allocator().release();
 
-	psType policySiblings;
+	c.weight = weight;
 
-	// clear the open/closed list
-	openList.clear();
-	closedList.clear();
-	aStarTree.clear();
+	// bound the levels of the tree for the beam search
+	c.beam.reset(search == BEAM ? beamWidth : 0);
+
+	// keep the explored graph for the next search of the same problem
+	c.currGraph = (search == REPLAN) ? findSearchGraph(c) : 0;
+
+	// the tasks of a round may share a graph, they search it one after another
+	if (c.currGraph != 0)
+		c.graphGuard = unique_lock<mutex>(c.currGraph->lock);
+
+	// otherwise the successors are taken from the transitions found by the earlier searches
+	c.currTransitions = (c.currGraph == 0) ? findTransitionGraph(c) : 0;
 
 	// start state is the first state in the current observed model
-	InternalState startState = InternalState(-1,mapping(currObservedStates[0], mMap),0);
+	InternalState startState = InternalState(-1,mapping(c.currObservedStates[0], mMap),0);
 
 	// initialize the nextTo property
-	startState.state.updateNextTo();
+	startState.state.edit().updateNextTo();
 
 	// calculate distance for start state
 	switch (modelState)
 	{
 		case HANDCODE:
-			startState.distance = handCode(currObservedStates[startState.extStateNum], startState.state);
+			startState.distance = handCode(c, c.currObservedStates[startState.extStateNum], startState.state);
 			break;
 		case HANDCODE_EW:
-			startState.distance = simpleDistance(currObservedStates[startState.extStateNum], startState.state);
+			startState.distance = simpleDistance(c, c.currObservedStates[startState.extStateNum], startState.state);
 			break;
 		default:
-			startState.distance = calcDistance(currObservedStates[startState.extStateNum], startState.state, EXPLOITATION);
+			startState.distance = calcDistance(c, startState, EXPLOITATION);
 	}
 		
 	// create a node for start state
-	Node newNode = Node(startState, 0, startState.distance, calcHeuristicCost(startState));
+	Node newNode = Node(startState, 0, startState.distance, calcHeuristicCost(c, startState));
 	treeIter = aStarTree.set_head (newNode);
+	c.nodeTable.insert(treeIter.node);
+	c.beam.insert(treeIter.node);
 	
 	// put start node into open list
-	openList.push_back(treeIter.node);
-	
-	currState = openList.front();
-	// loop until the first state in open list correspond to the last observed state
-	while (!isGoalState(currState->data.state)) 
-	{
-		// find its location in the A* tree
-		parentIter = find(aStarTree.begin(), aStarTree.end(), currState->data);
+	c.openList.push(treeIter.node, newNode.g + c.weight*newNode.h);
+}
+
+/*
+	Function: expandNode
+	Desc.	: expand the first node of the open list, its successors are added to the A* tree and the open list
+	Para.	: modelState, EXPLORATION, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  aStarTree, the A* tree
+			  currState, the first node of the open list
+	Return	: None
+*/
+void Imitation::expandNode(SearchContext& c, int modelState, searchTree& aStarTree, treeNode *currState)
+{
+	double newCost, hCost;
+	bool findSuccessor;
+
+	searchTree::pre_order_iterator treeIter, parentIter;
 
-		findSuccessor = false;
+	// sequence of states selected by the internal model
+	list<InternalState> successors;
+	list<InternalState>::iterator successorIter;
 
-		// remove current state from open list
-		openList.erase(openList.begin());
+	treeNode *displaced;
 
-		// generate sucessors of current state
-		successors = currState->data.state.genSuccessors(actions, intObjects);
+	Node newNode;
 
-		// choose a successor
-		if (modelState == EXPLORATION)
-			chooseASuccessor(successors);
+	// its location in the A* tree
+	parentIter = searchTree::pre_order_iterator(currState);
 
-		// handle each successor
-		for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+	findSuccessor = false;
+
+	// remove current state from open list
+	c.openList.pop();
+	c.beam.close(currState);
+
+	// generate sucessors of current state and their distance
+	generateSuccessors(c, modelState, currState->data.state, successors);
+
+	// choose a successor
+	if (modelState == EXPLORATION)
+		chooseASuccessor(c, successors);
+
+	// handle each successor
+	for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+	{
+		// calculate new g
+		newCost = currState->data.g + calcActionCost(successorIter->action) + successorIter->distance;
+		hCost = calcHeuristicCost(c, (*successorIter));
+		newNode = Node(move(*successorIter), currState->data.level + 1, newCost, hCost);
+		
+		//remove from open list that has higher cost 
+		treeIter = c.nodeTable.find(newNode);
+		if (treeIter.node != 0)
+		{
+			// skip when exists on the open list which has less cost
+			if (newNode.g >= treeIter->g)
+				continue;
+
+			// remove the node and its children from open list and node table
+			removeFromList(c, aStarTree, treeIter.node);
+
+			// remove node from A* tree
+			aStarTree.erase(treeIter);
+		}
+
+		// beam search, drop the node or the worst open node of its level when the level is full
+		if (!c.beam.admit(newNode.level, newNode.f, displaced))
+			continue;
+		if (displaced != 0)
 		{
-			switch (modelState)
+			removeFromList(c, aStarTree, displaced);
+			aStarTree.erase(searchTree::pre_order_iterator(displaced));
+		}
+		
+		treeIter = aStarTree.append_child(parentIter, move(newNode));
+		c.nodeTable.insert(treeIter.node);
+		c.beam.insert(treeIter.node);
+		if (modelState != EXPLORATION)
+			// add successor to the open list, the position is determined by the cost
+			c.openList.push(treeIter.node, treeIter->g + c.weight*treeIter->h);
+		else
+			if (findSuccessor)
+				// its siblings are appended at the back of the open list
+				c.openList.pushBack(treeIter.node);
+			else
 			{
-				case HANDCODE:
-					successorIter->distance = handCode(currObservedStates[successorIter->extStateNum], successorIter->state);
-					break;
-				case HANDCODE_EW:
-					successorIter->distance = simpleDistance(currObservedStates[successorIter->extStateNum], successorIter->state);
-					break;
-				default:
-					// calculate difference between observed state and internal state, update gVal
-					successorIter->distance = calcDistance(currObservedStates[successorIter->extStateNum], successorIter->state, EXPLOITATION);
+				findSuccessor = true;
+
+				// the first successor will be inserted in the front of the open list
+				c.openList.pushFront(treeIter.node);
 			}
+	}
 
-			// calculate new g
-			newCost = currState->data.g + calcActionCost(successorIter->action) + successorIter->distance;
-			newNode = Node((*successorIter), currState->data.level + 1, newCost, calcHeuristicCost((*successorIter)));
-			
-			//remove from open list that has higher cost 
-			treeIter = find(aStarTree.begin(), aStarTree.end(), newNode);
-			if (treeIter != aStarTree.end())
-			{
-				// skip when exists on the open list which has less cost
-				if (newNode.g >= treeIter->g)
-					continue;
+	// current node has been expanded
+	currState->data.closed = true;
+}
 
-				// remove the node and its children from open/closed list
-				removeFromList(aStarTree, treeIter.node);
+/*
+	Function: generateSuccessors
+	Desc.	: generate the successors of a state, or take them from the explored graph, and calculate their distance
+	Para.	: modelState, EXPLORATION, EXPLOITATION, HANDCODE or HANDCODE_EW
+			  s, the state
+			  successors, the successors
+	Return	: None
+*/
+void Imitation::generateSuccessors(SearchContext& c, int modelState, InternalState& s, list<InternalState>& successors)
+{
+	size_t i;
+	list<InternalState>::iterator successorIter;
 
-				// remove node from A* tree
-				aStarTree.erase(treeIter);
-			}
-			
-			treeIter = aStarTree.append_child(parentIter, newNode);
-			if (modelState != EXPLORATION)
-				// add successor to the open list, the position is determined by the cost
-				addToList(openList, treeIter.node);
-			else
-				if (findSuccessor)
-					// its siblings are appended at the back of the open list
-					openList.push_back(treeIter.node);
-				else
-				{
-					findSuccessor = true;
+	if (c.currGraph != 0)
+		successors = c.currGraph->successors(s);
+	else if (c.currTransitions != 0)
+		c.currTransitions->successors(s, successors);
+	else
+		successors = s.genSuccessors(ActionTable(actions, c.intObjects));
 
-					// the first successor will be inserted in the front of the open list
-					openList.insert(openList.begin(), treeIter.node);
-				}
-		}
+	switch (modelState)
+	{
+		case HANDCODE:
+			for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+				successorIter->distance = handCode(c, c.currObservedStates[successorIter->extStateNum], successorIter->state);
+			break;
+		case HANDCODE_EW:
+			for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+				successorIter->distance = simpleDistance(c, c.currObservedStates[successorIter->extStateNum], successorIter->state);
+			break;
+		default:
+			// calculate difference between observed state and internal state of all the successors at once
+			c.batchStates.clear();
+			for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+				c.batchStates.push_back(&*successorIter);
 
-		// Add current node to closed list, just add the back
-		closedList.push_back(currState);
+			calcDistances(c, c.batchStates, c.batchDistances, &s);
 
-		// get next node on the open list
-		currState = openList.front();
+			i = 0;
+			for (successorIter=successors.begin(); successorIter != successors.end(); ++successorIter) 
+				successorIter->distance = c.batchDistances[i++];
 	}
+}
 
-	// get the policy and siblings
-	policySiblings = getPolicy(aStarTree);
+/*
+	Function: endSearch
+	Desc.	: cleanup after a search
+	Para.	: None
+	Return	: None
+*/
+void Imitation::endSearch(SearchContext& c)
+{
+	// cleanup open list and node table
+	c.openList.clear();
+	c.nodeTable.clear();
+	c.currGraph = 0;
+	c.currTransitions = 0;
+	if (c.graphGuard.owns_lock())
+		c.graphGuard.unlock();
+}
 
-	backpropagateHeuristicCost(aStarTree);
+/*
+	Function: findSearchGraph()
+	Desc.	: look for the graph explored by the earlier searches of the current problem
+	Para.	: None
+	Return	: the graph, an empty one is created when the problem hasn't been searched before
+	Note	: a problem is the current observed model and the internal objects, so each demonstration and 
+			  imitation has its own graph
+*/
+SearchGraph *Imitation::findSearchGraph(SearchContext& c)
+{
+	list<SearchGraph>::iterator p;
+	lock_guard<mutex> guard(graphLock);
 
-	// cleanup open/closed list
-	openList.clear();
-	closedList.clear();
+	for (p = searchGraphs.begin(); p != searchGraphs.end(); ++p)
+		if (p->matches(c.currObservedObjects, c.currObservedStates, c.intObjects))
+			return &(*p);
 
-	return policySiblings;
+	searchGraphs.emplace_back(c.currObservedObjects, c.currObservedStates, c.intObjects, actions);
+	return &searchGraphs.back();
+}
+
+/*
+	Function: findTransitionGraph()
+	Desc.	: look for the transitions found by the earlier searches of a context with the same internal objects
+	Para.	: None
+	Return	: the graph, an empty one is created for new internal objects
+	Note	: each context has its own graphs, so they are used without a lock
+*/
+TransitionGraph *Imitation::findTransitionGraph(SearchContext& c)
+{
+	list<TransitionGraph>::iterator p;
+
+	for (p = c.transitionGraphs.begin(); p != c.transitionGraphs.end(); ++p)
+		if (p->matches(c.intObjects))
+			return &(*p);
+
+	c.transitionGraphs.emplace_back(c.intObjects, actions);
+	return &c.transitionGraphs.back();
+}
+
+/*
+	Function: setSearch()
+	Desc.	: choose the search algorithm used to find a policy
+	Para.	: searchTypeVal, ASTAR, REPLAN, BEAM, ANYTIME, IDASTAR or LAYERED
+			  beamWidthVal, number of nodes kept on each level of the tree by BEAM
+	Return	: None
+*/
+void Imitation::setSearch(int searchTypeVal, int beamWidthVal)
+{
+	searchType = searchTypeVal;
+	beamWidth = beamWidthVal < 1 ? 1 : beamWidthVal;
+	searchGraphs.clear();
+}
+
+/*
+	Function: setTimeBudget()
+	Desc.	: set the time each search may take with ANYTIME
+	Para.	: seconds, the time budget
+	Return	: None
+*/
+void Imitation::setTimeBudget(double seconds)
+{
+	timeBudget = seconds;
+}
+
+/*
+	Function: setParentEvaluation()
+	Desc.	: set whether the successors of a state are evaluated from the hidden units' input of the state
+	Para.	: on, true to evaluate them from it, false to evaluate them in full
+	Return	: None
+*/
+void Imitation::setParentEvaluation(bool on)
+{
+	parentEvaluation = on;
+}
+
+/*
+	Function: setTableEvaluation()
+	Desc.	: set whether the states without a graph or a parent are evaluated from the embedding table
+	Para.	: on, true to evaluate them from the table, false to evaluate them in full
+	Return	: None
+*/
+void Imitation::setTableEvaluation(bool on)
+{
+	tableEvaluation = on;
+}
+
+/*
+	Function: setParallel()
+	Desc.	: set how the training tasks are run
+	Para.	: numOfThreads, number of threads, 1 runs the tasks one after another
+			  seedVal, seed of the tasks' random numbers, the training gives the same result for the same seed
+			  whatever the number of threads is
+	Return	: None
+*/
+void Imitation::setParallel(int numOfThreads, unsigned long long seedVal)
+{
+	pool.resize(numOfThreads < 1 ? 1 : numOfThreads);
+	seed = seedVal;
 }
 
-void Imitation::removeFromList(const tree<Node>& aStarTree, treeNode *node)
+/*
+	Function: removeFromList()
+	Desc.	: remove a node and all its descendants from the open list, the node table and the beam levels
+	Para.	: aStarTree, the A* tree the node belongs to
+			  node, the node which is going to be removed
+	Return	: None
+	Note	: call it before the node is erased from the A* tree
+*/
+void Imitation::removeFromList(SearchContext& c, const searchTree& aStarTree, treeNode *node)
 {
-	// remove itself from open/closed list
-	openList.erase(remove(openList.begin(), openList.end(), node), openList.end());
-	closedList.erase(remove(closedList.begin(), closedList.end(), node), closedList.end());
+	// remove itself from open list and node table
+	c.openList.remove(node);
+	c.nodeTable.erase(node);
+	c.beam.erase(node);
 	
 	if (node->first_child !=0)
-		// remove its children from open/closed list
-		for (tree<Node>::sibling_iterator siblingIter = aStarTree.begin(node); siblingIter != aStarTree.end(node); ++siblingIter)
-			removeFromList(aStarTree, siblingIter.node);
+		// remove its children from open list and node table
+		for (searchTree::sibling_iterator siblingIter = aStarTree.begin(node); siblingIter != aStarTree.end(node); ++siblingIter)
+			removeFromList(c, aStarTree, siblingIter.node);
 }
 /*
 	Function: chooseASuccessor()
 	Desc	: Reorder the successors based on a distance exploration
-	Para	: All the successor of current node in the A* tree
+	Para	: All the successor of current node in the A* tree, their distance is the network's output
 	Return	: None
+	Note	: the distances are left unchanged, only the order is explored
 */
-void Imitation::chooseASuccessor(list<InternalState> &successors)
+void Imitation::chooseASuccessor(SearchContext& c, list<InternalState> &successors)
 {
+	size_t i;
 	list<InternalState>::iterator iter;
+	vector<pair<double, list<InternalState>::iterator> > order;
 
 	for (iter = successors.begin(); iter!=successors.end(); ++iter)
 		// random generate a distance for each successor based on its mean and variance
-		iter->distance = calcDistance(currObservedStates[iter->extStateNum], iter->state, EXPLORATION);
+		order.push_back(make_pair(randomDistance(c, iter->distance), iter));
+
+	// reorder the successors based on the generated distance, equal ones keep their order
+	stable_sort(order.begin(), order.end(), [](const pair<double, list<InternalState>::iterator>& a, const pair<double, list<InternalState>::iterator>& b) {
+		return a.first < b.first;
+	});
 
-	// reorder the successors based on its distance
-	successors.sort();
+	for (i=0; i<order.size(); ++i)
+		successors.splice(successors.end(), successors, order[i].second);
 }
 
 /*
@@ -1368,37 +2274,37 @@ void Imitation::batchUpdate(double totRewardDiff)
 bool Imitation::policyIsSatisfied(ObservedModel &demo, InternalModel &imit)
 {
 	// set current observed model
-	setCurrentObservedModel(demo.objects, demo.states, imit.objects);
+	setCurrentObservedModel(ctx, demo.objects, demo.states, imit.objects);
 
 	// recalculate distance
-	recalcDistance(imit);
+	recalcDistance(ctx, imit);
 	
 	// call A* search algorithm, each A* tree for each task
-	currPolicySibling = AStarSearch(EXPLOITATION, currAStarTree);
+	ctx.currPolicySibling = AStarSearch(ctx, EXPLOITATION, ctx.currAStarTree);
 	
 	// calculate reward for current policy
-	currReward = calcReward(currPolicySibling.first, demo.num);	
+	currReward = calcReward(ctx, ctx.currPolicySibling.first, demo.num);	
 	if (imit.reward > currReward)
 	{
 		if (DEBUG_MODE)
 		{
 			fout_policy << "current policy after update: " << endl;
-			printNodes(fout_policy, currPolicySibling.first);
+			printNodes(ctx, fout_policy, ctx.currPolicySibling.first);
 
 			fout_policy << "new policy after update: " << endl;
-			printNodes(fout_policy, imit.policy);
+			printNodes(ctx, fout_policy, imit.policy);
 		}
 		
-		generateDistance(imit, imit.reward - currReward);
+		generateDistance(ctx, imit, imit.reward - currReward);
 	}
 	else
 	{
 		// update with current model which has higher reward
 		imit.reward = currReward;
-		imit.policy = currPolicySibling.first;
-		imit.siblings = currPolicySibling.second;
+		imit.policy = ctx.currPolicySibling.first;
+		imit.siblings = ctx.currPolicySibling.second;
 		
-		generateDistance(imit);
+		generateDistance(ctx, imit);
 	}
 
 	return (currReward >= imit.reward);
@@ -1412,14 +2318,14 @@ bool Imitation::policyIsSatisfied(ObservedModel &demo, InternalModel &imit)
 			  delta=0, the expected delta * reward difference
 	Return	: None
 */
-void Imitation::addToTrainingSet (const InternalState& state, double output, double rewardDiff, double delta)
+void Imitation::addToTrainingSet (SearchContext& c, const InternalState& state, double output, double rewardDiff, double delta)
 {
 	int iPos;
 
 	vector<double> input, expectedOutput;
 
 	// convert state pair into numeric representation
-	input = convert(currObservedStates[state.extStateNum], state.state);
+	input = convert(c, c.currObservedStates[state.extStateNum], state.state);
 
 	// check whether the same input exists already
 	iPos = search(inputs, input);
@@ -1451,13 +2357,13 @@ void Imitation::training()
 {
 	bool unChanged;
 	int i, j, iCount, iCountUnchanged;
-	double newReward, totRewardDiff;
+	long numOfRounds;
+	double totRewardDiff;
 
 	// stream interface
 	fstream fout_AStar, fout_solution;
 	
 	// new internal model
-	psType newPolicySibling;
 	InternalModel newIntModel;
 
 	// imitation
@@ -1470,9 +2376,14 @@ void Imitation::training()
 	// output stream for A* star tree
 	fout_AStar.open("o_astar.txt", ios::out);
 
+	// one search context for each demonstration
+	while (taskContexts.size() < newDemos.size())
+		taskContexts.push_back(new SearchContext());
+
 	// after each run, reward/penalty will be given, this is provided by the user or calculation
 	iCount = 0;
 	iCountUnchanged = 0;
+	numOfRounds = 0;
 	while (true)
 	{
 		// check if key 'x' is press or no more change happend during last 6000 iterations, if yes, exit loop
@@ -1489,66 +2400,90 @@ void Imitation::training()
 		{
 			fout_solution << endl << "round: " << iCount << " " << iCountUnchanged << " std. Dev: " << stdDeviation << endl;
 			fout_AStar << endl << "round: " << iCount << " " << iCountUnchanged << " std. Dev: " << stdDeviation << endl;
+
+			// tree nodes handed out by the pools during the last round, the heap allocations they needed and the 
+			// largest number of nodes a pool held, and the distances found in the caches of the searches
+			vector<SearchContext *> contexts(taskContexts.begin(), taskContexts.end());
+			contexts.push_back(&ctx);
+			long nodes = 0, chunks = 0, peak = 0, hits = 0, misses = 0;
+			for (i=0; i<contexts.size(); ++i)
+			{
+				NodePool<treeNode> *pools[2] = { &contexts[i]->currNodePool, &contexts[i]->newNodePool };
+				for (j=0; j<2; ++j)
+				{
+					nodes += pools[j]->allocations;
+					chunks += pools[j]->chunkAllocations;
+					peak = max(peak, pools[j]->peak);
+					pools[j]->resetCounters();
+				}
+
+				hits += contexts[i]->distanceCache.hits;
+				misses += contexts[i]->distanceCache.misses;
+				contexts[i]->distanceCache.resetCounters();
+			}
+			fout_AStar << "tree nodes: " << nodes << " heap allocations: " << chunks << " peak: " << peak << endl;
+			fout_AStar << "distance cache hits: " << hits << " misses: " << misses << endl;
+
+			// heap allocations of the last round, all threads together, when the build counts them
+			if (HeapCounter::enabled())
+			{
+				fout_AStar << "heap allocations: " << HeapCounter::allocations() << " bytes: " << HeapCounter::bytes() << endl;
+				HeapCounter::reset();
+			}
 		}
 		unChanged = true;
 		totRewardDiff = 0;
 		clearTrainingSet();
 		idxOfCurrImits.clear();
+		// search the current and a new policy of each demonstration, the tasks are independent
+		pool.run(newDemos.size(), [this, numOfRounds](int k) {
+			searchTask(*taskContexts[k], newDemos[k], mixHash(seed + mixHash(((unsigned long long)numOfRounds << 32) | k)));
+		});
+		++numOfRounds;
+
+		// go through the results in the order of the demonstrations, so the training set and the output 
+		// don't depend on the number of threads
 		for (i=0; i<newDemos.size(); ++i)
 		{
-			// load observed model
-			setCurrentObservedModel(newDemos[i].objects, newDemos[i].states);
-
-			// change imitation environment for multi-action task
-			if (currObservedStates.size() > 2)
-			//if (newDemos[i].num != -1)
-				changeImitationEnvironment(newDemos[i].num);
-
-			// generate the current policy and calculate the reward
-			currPolicySibling = AStarSearch(EXPLOITATION, currAStarTree);
-			currReward = calcReward(currPolicySibling.first, newDemos[i].num);
+			SearchContext& c = *taskContexts[i];
 
 			// output reward
-			fout_oldRew << "task: " << i << setw(4) << currObservedObjects[0].color.substr(0,3) << setw(4) << currObservedObjects[0].texture.substr(0,3) << 
-				setw(4) << intObjects[0].color.substr(0,3) << setw(4) << intObjects[0].texture.substr(0,3) << setw(4) << currReward << endl;
+			fout_oldRew << "task: " << i << setw(4) << c.currObservedObjects[0].color.str().substr(0,3) << setw(4) << c.currObservedObjects[0].texture.str().substr(0,3) << 
+				setw(4) << c.intObjects[0].color.str().substr(0,3) << setw(4) << c.intObjects[0].texture.str().substr(0,3) << setw(4) << c.currReward << endl;
 			
 			// output current policy
 			if (DEBUG_MODE)
 			{
 				fout_AStar << "task: " << i << " A* tree: "<< endl;
-				printTree(fout_AStar, currAStarTree);
+				printTree(fout_AStar, c.currAStarTree);
 
-				fout_solution << "task: " << i << " old Reward: " << currReward << endl;
-				printNodes(fout_solution, currPolicySibling.first);
+				fout_solution << "task: " << i << " old Reward: " << c.currReward << endl;
+				printNodes(c, fout_solution, c.currPolicySibling.first);
 			}
 
-			// generate a new policy and calculate reward
-			newPolicySibling = AStarSearch(EXPLORATION, newAStarTree);
-			newReward = calcReward(newPolicySibling.first, newDemos[i].num);
-			
 			// output reward distribution
-			fout_rew << "task: " << i << setw(4) << currObservedObjects[0].color.substr(0,3) << setw(4) << currObservedObjects[0].texture.substr(0,3) << 
-				setw(4) << intObjects[0].color.substr(0,3) << setw(4) << intObjects[0].texture.substr(0,3) << setw(4) << newReward << endl;
+			fout_rew << "task: " << i << setw(4) << c.currObservedObjects[0].color.str().substr(0,3) << setw(4) << c.currObservedObjects[0].texture.str().substr(0,3) << 
+				setw(4) << c.intObjects[0].color.str().substr(0,3) << setw(4) << c.intObjects[0].texture.str().substr(0,3) << setw(4) << c.newReward << endl;
 
 			if (DEBUG_MODE)
 			{
-				fout_solution << "task: " << i << " new Reward: " << newReward << endl;
-				printNodes(fout_solution, newPolicySibling.first, true);
+				fout_solution << "task: " << i << " new Reward: " << c.newReward << endl;
+				printNodes(c, fout_solution, c.newPolicySibling.first, true);
 			}
-			cout << "task: " << i << " old reward: " << currReward << " new reward: " << newReward << endl << endl;
+			cout << "task: " << i << " old reward: " << c.currReward << " new reward: " << c.newReward << endl << endl;
 
 			// if the current policy is as good as the new one, go for next exploration
-			if (newReward > currReward)
+			if (c.newReward > c.currReward)
 			{	
 				unChanged = false;
-				totRewardDiff += newReward - currReward;
-				newIntModel = InternalModel(intObjects, newPolicySibling.first, newPolicySibling.second, newReward);
-				generateDistance(newIntModel, newReward - currReward);
+				totRewardDiff += c.newReward - c.currReward;
+				newIntModel = InternalModel(c.intObjects, c.newPolicySibling.first, c.newPolicySibling.second, c.newReward);
+				generateDistance(c, newIntModel, c.newReward - c.currReward);
 			}
 			else
 			{
-				newIntModel = InternalModel(intObjects, currPolicySibling.first, currPolicySibling.second, currReward);
-				generateDistance(newIntModel);
+				newIntModel = InternalModel(c.intObjects, c.currPolicySibling.first, c.currPolicySibling.second, c.currReward);
+				generateDistance(c, newIntModel);
 			}
 			
 			// save imitation environment for each demonstration (Don't save policy, it may change)
@@ -1565,7 +2500,7 @@ void Imitation::training()
 			{
 				// check whether the same imitation case appeared alreay
 				for (j=0; j<newImits[i].size(); ++j)
-					if (equal(intObjects.begin(), intObjects.end(), newImits[i][j].objects.begin()))
+					if (equal(c.intObjects.begin(), c.intObjects.end(), newImits[i][j].objects.begin()))
 						break;
 
 				// if not, insert new entries
@@ -1605,7 +2540,36 @@ void Imitation::training()
 	fout_AStar.close();
 }
 
-void Imitation::printNodes(fstream &fout, const vector<Node>& nodes,  bool standardOutput)
+/*
+	Function: searchTask()
+	Desc.	: one training task, search the current policy and a new policy of a demonstration
+	Para.	: c, the task's search context, the results are left in it
+			  demo, the demonstration
+			  taskSeed, seed of the task's random numbers
+	Return	: None
+	Note	: the tasks of a round run at the same time, they only read the shared members
+*/
+void Imitation::searchTask(SearchContext& c, const ObservedModel& demo, unsigned long long taskSeed)
+{
+	c.r.seed(taskSeed);
+
+	// load observed model
+	setCurrentObservedModel(c, demo.objects, demo.states);
+
+	// change imitation environment for multi-action task
+	if (c.currObservedStates.size() > 2)
+		changeImitationEnvironment(c, demo.num);
+
+	// generate the current policy and calculate the reward
+	c.currPolicySibling = AStarSearch(c, EXPLOITATION, c.currAStarTree);
+	c.currReward = calcReward(c, c.currPolicySibling.first, demo.num);
+
+	// generate a new policy and calculate reward
+	c.newPolicySibling = AStarSearch(c, EXPLORATION, c.newAStarTree);
+	c.newReward = calcReward(c, c.newPolicySibling.first, demo.num);
+}
+
+void Imitation::printNodes(SearchContext& c, fstream &fout, const vector<Node>& nodes,  bool standardOutput)
 {
 	int i;
 	vector<vector<string> > intSState;
@@ -1619,7 +2583,7 @@ void Imitation::printNodes(fstream &fout, const vector<Node>& nodes,  bool stand
 		fout << " T: " << nodes[i].f << endl;
 		
 		//fout << nodes[i].toString();
-		intSState = stateToString(nodes[i].state.state);
+		intSState = stateToString(c, nodes[i].state.state);
 		for (int j=0; j<intSState.size(); ++j)
 		{
 			for (int k=0; k<intSState[j].size(); ++k)
@@ -1630,10 +2594,10 @@ void Imitation::printNodes(fstream &fout, const vector<Node>& nodes,  bool stand
 	fout << endl;
 }
 
-void Imitation::printTree (fstream &fout, const tree<Node>& aStarTree, bool standardOutput)
+void Imitation::printTree (fstream &fout, const searchTree& aStarTree, bool standardOutput)
 {
 	
-	tree<Node>::pre_order_iterator treeIter;
+	searchTree::pre_order_iterator treeIter;
 
 	if(!aStarTree.is_valid(aStarTree.begin())) 
 		return;
@@ -1698,10 +2662,20 @@ void Imitation::loadLearnedDemo(const string fileName)
 	Para	: intModel, internal model
 	Return	: None
 */
-void Imitation::recalcDistance(InternalModel &intModel)
+void Imitation::recalcDistance(SearchContext& c, InternalModel &intModel)
 {
 	int i, levelOfParent;
 	double gOfParent;
+	const int N = intModel.policy.size();
+
+	// distances of the policy and the siblings in one network pass
+	c.batchStates.clear();
+	for (i=0; i<intModel.policy.size(); ++i)
+		c.batchStates.push_back(&intModel.policy[i].state);
+	for (i=0; i<intModel.siblings.size(); ++i)
+		c.batchStates.push_back(&intModel.siblings[i].state);
+
+	calcDistances(c, c.batchStates, c.batchDistances);
 	
 	// update distance for those nodes in the policy
 	for (i=0; i<intModel.policy.size(); ++i)
@@ -1711,7 +2685,7 @@ void Imitation::recalcDistance(InternalModel &intModel)
 		else
 			gOfParent = intModel.policy[i-1].g;
 		
-		recalcDistance(intModel.policy[i], gOfParent);
+		recalcDistance(c, intModel.policy[i], gOfParent, c.batchDistances[i]);
 	}
 	
 	// update distance for those nodes in the A* tree (sibling)
@@ -1720,7 +2694,7 @@ void Imitation::recalcDistance(InternalModel &intModel)
 		// parent's level
 		levelOfParent = intModel.siblings[i].level-1;
 
-		recalcDistance(intModel.siblings[i], intModel.policy[levelOfParent].g);
+		recalcDistance(c, intModel.siblings[i], intModel.policy[levelOfParent].g, c.batchDistances[N+i]);
 	}
 
 	// backpropagate the heuristic cost
@@ -1732,15 +2706,11 @@ void Imitation::recalcDistance(InternalModel &intModel)
 	Desc	: recalculate the distance and other cost for a single node
 	Para	: node, the node that you want to recalculate its cost
 			  gOfParent, the g of its parent
+			  newDistance, its distance given by the current network
 	Return	: None
 */
-void Imitation::recalcDistance(Node &node, double gOfParent)
+void Imitation::recalcDistance(SearchContext& c, Node &node, double gOfParent, double newDistance)
 {
-	double newDistance;
-
-	// recalculate its distance
-	newDistance = calcDistance(currObservedStates[node.state.extStateNum], node.state.state, EXPLOITATION);
-
 	// update distance
 	node.state.distance = newDistance;
 
@@ -1748,7 +2718,7 @@ void Imitation::recalcDistance(Node &node, double gOfParent)
 	node.g = gOfParent + calcActionCost(node.state.action) + newDistance;
 
 	// for the policy nodes, h may be changed, recalculate
-	node.h = calcHeuristicCost(node.state);
+	node.h = calcHeuristicCost(c, node.state);
 
 	// update f
 	node.f = node.g + node.h;
@@ -1786,7 +2756,7 @@ void Imitation::backpropagateHeuristicCost(vector<Node> &policy)
 			  rewardDiff, the difference between new reward and current reward, default = 0
 	Return	: None
 */
-void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
+void Imitation::generateDistance(SearchContext& c, InternalModel &intModel, double rewardDiff)
 {
 	int i, level;
 	vector<Node> aStarTree;
@@ -1797,18 +2767,18 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 		// policy nodes in the new A* tree
 		//for (iter = intModel.policy.begin(); iter != intModel.policy.end(); ++iter)
 		for (iter = intModel.policy.begin()+1; iter != intModel.policy.end(); ++iter)	// skip root node
-			addToTrainingSet(iter->state, iter->state.distance);
+			addToTrainingSet(c, iter->state, iter->state.distance);
 		
 		// siblings in the new A* tree
 		for (iter = intModel.siblings.begin(); iter != intModel.siblings.end(); ++iter)
-			addToTrainingSet(iter->state, iter->state.distance);
+			addToTrainingSet(c, iter->state, iter->state.distance);
 
 		return;
 	}
 
 	// find out the first unmatched nodes between the current and new policy
 	typedef pair<vector<Node>::iterator, vector<Node>::iterator> misMatchType;
-	misMatchType misMatch = mismatch(currPolicySibling.first.begin(), currPolicySibling.first.end(), intModel.policy.begin(), mem_fun_ref(&Node::operator ==));
+	misMatchType misMatch = mismatch(c.currPolicySibling.first.begin(), c.currPolicySibling.first.end(), intModel.policy.begin(), mem_fun_ref(&Node::operator ==));
 
 	int matchLevel = misMatch.second->level-1;
 	// the maximum cost in the current policy, exclude matched nodes
@@ -1820,8 +2790,8 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 	cout << "new policy cost: " << newPolicyCost << " curr. policy cost:" << currPolicyCost << endl;
 
 	// for current A* tree, only consider those nodes that have the maximum cost along each branch
-	tree<Node>::pre_order_iterator treeIter = find(currAStarTree.begin(), currAStarTree.end(), (*--misMatch.first));
-	for (tree<Node>::sibling_iterator siblingIter=currAStarTree.begin(treeIter); siblingIter != currAStarTree.end(treeIter); ++siblingIter)
+	searchTree::pre_order_iterator treeIter = find(c.currAStarTree.begin(), c.currAStarTree.end(), (*--misMatch.first));
+	for (searchTree::sibling_iterator siblingIter=c.currAStarTree.begin(treeIter); siblingIter != c.currAStarTree.end(treeIter); ++siblingIter)
 	{
 		// skip new policy node
 		if ((*siblingIter) == (*misMatch.second))
@@ -1831,16 +2801,16 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 		double maxCost = siblingIter->f;
 		
 		// stop when the iterator pointer to next sibling or the end of iterator
-		tree<Node>::pre_order_iterator subTreeIter = siblingIter;
+		searchTree::pre_order_iterator subTreeIter = siblingIter;
 		while(true)
 		{
 			aStarTree.push_back(subTreeIter.node->data);
 
 			// find minimum child
-			tree<Node>::pre_order_iterator minIter= min_element(currAStarTree.begin(subTreeIter), currAStarTree.end(subTreeIter));
+			searchTree::pre_order_iterator minIter= min_element(c.currAStarTree.begin(subTreeIter), c.currAStarTree.end(subTreeIter));
 			
 			// check whether the minimum child has same cost as current node
-			if (minIter == currAStarTree.end(subTreeIter) || minIter->f != subTreeIter->f)
+			if (minIter == c.currAStarTree.end(subTreeIter) || minIter->f != subTreeIter->f)
 				break;	// exit when current node's cost is the maximum
 
 			subTreeIter = minIter;
@@ -1917,7 +2887,7 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 		}
 
 		// add to the training set
-		addToTrainingSet(intModel.policy[i].state, intModel.policy[i].state.distance, rewardDiff, delta);
+		addToTrainingSet(c, intModel.policy[i].state, intModel.policy[i].state.distance, rewardDiff, delta);
 	}
 
 	// compare each sibling in the new A* tree with new policy cost
@@ -1935,7 +2905,7 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 			delta = (diff/posCount * (1 + MARGIN_PER) + MARGIN) * rewardDiff;
 
 		// add to the training set
-		addToTrainingSet(intModel.siblings[i].state, intModel.siblings[i].state.distance, rewardDiff, delta);
+		addToTrainingSet(c, intModel.siblings[i].state, intModel.siblings[i].state.distance, rewardDiff, delta);
 	}
 
 	// compare each node in the current A* tree with new policy cost
@@ -1950,7 +2920,7 @@ void Imitation::generateDistance(InternalModel &intModel, double rewardDiff)
 			delta = (diff/posCount * (1 + MARGIN_PER) + MARGIN) * rewardDiff;
 
 		// add to the training set
-		addToTrainingSet(aStarTree[i].state, aStarTree[i].state.distance, rewardDiff, delta);
+		addToTrainingSet(c, aStarTree[i].state, aStarTree[i].state.distance, rewardDiff, delta);
 	}
 }
 
@@ -1974,10 +2944,10 @@ double Imitation::calcActionCost(int num)
 	Para.	: lBackpropagate, whether the cost is backpropagated up or not
 	Return	: all the nodes in the A* tree
 */
-void Imitation::backpropagateHeuristicCost(tree<Node>& aStarTree)
+void Imitation::backpropagateHeuristicCost(searchTree& aStarTree)
 {	
-	tree<Node>::iterator_base iter;
-	tree<Node>::sibling_iterator siblingIter;
+	searchTree::iterator_base iter;
+	searchTree::sibling_iterator siblingIter;
 
 	// get all the leaf node first
 	iter = aStarTree.begin();
@@ -1985,12 +2955,12 @@ void Imitation::backpropagateHeuristicCost(tree<Node>& aStarTree)
 		minMax(aStarTree, siblingIter);
 }
 
-double Imitation::minMax(tree<Node>& aStarTree, tree<Node>::iterator_base& iter)
+double Imitation::minMax(searchTree& aStarTree, searchTree::iterator_base& iter)
 {
 	if (iter.node->first_child ==0)
 		return iter->f;
 
-	tree<Node>::sibling_iterator siblingIter;
+	searchTree::sibling_iterator siblingIter;
 
 	double minChild = -1;
 	// find minimum cost among its children
@@ -2016,33 +2986,33 @@ double Imitation::minMax(tree<Node>& aStarTree, tree<Node>::iterator_base& iter)
 			  idxOfAttr, the index of attribute, this parameter will be pickup randomly when not provided or invalid
 	Return	: None
 */
-void Imitation::changeImitationEnvironment(int numOfDemo, int idxOfAttr)
+void Imitation::changeImitationEnvironment(SearchContext& c, int numOfDemo, int idxOfAttr)
 {
 	string newAttr;
 
 	// make imitation envrionment different from demonstration, random choose an attribute
 	if (idxOfAttr == -1 || idxOfAttr >= imitationEnv[numOfDemo].size())
-		idxOfAttr = rand() % imitationEnv[numOfDemo].size();
+		idxOfAttr = c.r.nextInt(imitationEnv[numOfDemo].size());
 
 	newAttr = imitationEnv[numOfDemo][idxOfAttr];
 	switch (numOfDemo)
 	{
 		case TRASH_CLEANING:
 			// cleaning task, change objA's texture attribute
-			intObjects[0].texture= newAttr;		// assume the object A is the first one on the object list
+			c.intObjects[0].texture= newAttr;		// assume the object A is the first one on the object list
 			break;
 		case TOY_COLLECTION:
 			// Toy collection, change Toy's color, exclusive green which indicate it is trash in the cleaning task
-			intObjects[0].color = newAttr;
+			c.intObjects[0].color = newAttr;
 			break;
 		case FUTON_MATCH_1:
 			// Futon-Sofa match 1, change the texture of futon1 and sofa1
-			intObjects[0].texture = newAttr;
-			intObjects[2].texture = newAttr;
+			c.intObjects[0].texture = newAttr;
+			c.intObjects[2].texture = newAttr;
 			break;
 		case FUTON_MATCH_2:
 			// Futon-Sofa match 2, change the texture of futon1
-			intObjects[0].texture = newAttr;
+			c.intObjects[0].texture = newAttr;
 			break;
 	}
 }
@@ -2060,9 +3030,9 @@ void Imitation::clearTrainingSet()
 	Para.	: mapping between observed model and internal model
 	return	: Object, internal representation of this instance
 */
-Object mapping(const Object& o, map<string,string>& m)
+Object mapping(const Object& o, const map<Symbol,Symbol>& m)
 {
-	return Object(m[o.name], m[o.color], m[o.texture]);
+	return Object(mapto(o.name, m), mapto(o.color, m), mapto(o.texture, m));
 }
 
 /*
@@ -2071,9 +3041,9 @@ Object mapping(const Object& o, map<string,string>& m)
 	Para.	: extState, the external representation of the relation
 	return	: Relation, internal state representation of the relation
 */
-Relation mapping(const Relation& r, map<string,string>& m)
+Relation mapping(const Relation& r, const map<Symbol,Symbol>& m)
 {
-	return Relation(m[r.relation], m[r.objA], m[r.objB]);
+	return Relation(mapto(r.relation, m), mapto(r.objA, m), mapto(r.objB, m));
 }
 
 /* 
@@ -2082,7 +3052,7 @@ Relation mapping(const Relation& r, map<string,string>& m)
 	Para.	: extStateNum, the number of external state
 	return	: internal state representation
 */
-State mapping(State s, map<string,string>& m)
+State mapping(const State& s, const map<Symbol,Symbol>& m)
 {	
 	State intState;
 
@@ -2257,11 +3227,15 @@ InternalModel readInternalModel (fstream &fin)
 	Desc.	: read action info through a stream interface and return an Action
 	Para.	: fin, a stream interface
 	Return	: an Action
+	Note	: the conditions can be followed by the objects a parameter may take, one line for each parameter, 
+			  e.g. "PARA_1 2 ObjA Toy". A parameter without a line may take any internal object.
+			  The effects which depend on the rest of the state follow, one line for each in the order they
+			  are applied, e.g. "EFFECT AWAY" or "EFFECT CARRY PARA_1", see Action
 */
 Action readAction(fstream &fin)
 {
-	int num;
-	string name;
+	int i, num, numOfObjects, para;
+	string name, object, line;
 	double cost;
 
 	State preConds, postConds;
@@ -2276,7 +3250,36 @@ Action readAction(fstream &fin)
 	// construct postcondition
 	postConds = readState(fin);
 	
-	return Action(num, name, preConds, postConds, cost);
+	Action action(num, name, preConds, postConds, cost);
+
+	// domains of the parameters and effects, the next action starts with its number
+	while ((fin >> ws) && isalpha(fin.peek()))
+	{
+		fin >> name;
+		if (name == "EFFECT")
+		{
+			getline(fin, line);
+			istringstream sin(line);
+			sin >> name;
+			para = (sin >> object && object == SYM_PARA_2.str()) ? 1 : 0;
+			if (!action.addEffect(name, para))
+				cout << "unknown effect " << name << " of " << action.name << endl;
+			continue;
+		}
+
+		para = (name == SYM_PARA_2.str()) ? 1 : 0;
+		if (para >= (int)action.domains.size())
+			action.domains.resize(para+1);
+
+		fin >> numOfObjects;
+		for (i=0; i<numOfObjects; ++i)
+		{
+			fin >> object;
+			action.domains[para].push_back(Symbol(object));
+		}
+	}
+
+	return action;
 }
 
 /*
@@ -2285,10 +3288,10 @@ Action readAction(fstream &fin)
 	Para.	: intState, an internal state
 	Return	: true if it is, otherwise false
 */
-bool Imitation::isGoalState(const InternalState& intState)
+bool Imitation::isGoalState(SearchContext& c, const InternalState& intState)
 {
 	// check whether the given state corresponds to the last observed state
-	return (intState.extStateNum ==currObservedStates.size()-1);
+	return (intState.extStateNum ==c.currObservedStates.size()-1);
 }
 
 /*
@@ -2297,9 +3300,9 @@ bool Imitation::isGoalState(const InternalState& intState)
 	Para.	: intState, an internal state
 	Return	: the distance between current observed state and final observed state
 */
-double Imitation::calcHeuristicCost(const InternalState& intState)
+double Imitation::calcHeuristicCost(SearchContext& c, const InternalState& intState)
 {
-	int goalState = currObservedStates.size()-1;
+	int goalState = c.currObservedStates.size()-1;
 
 	double cost=0;
 	for (int i=intState.extStateNum; i<goalState; ++i)	
@@ -2313,20 +3316,20 @@ double Imitation::calcHeuristicCost(const InternalState& intState)
 	Para.	: 
 	Return	: double
 */
-double Imitation::handCode(State& extState, State& intState)
+double Imitation::handCode(SearchContext& c, const State& extState, const State& intState)
 {
 	double hCost;
 
-	vector<vector<string> > intStateString = stateToString(intState);
-	vector<vector<string> > extStateString = stateToString(extState, false);
+	vector<vector<string> > intStateString = stateToString(c, intState);
+	vector<vector<string> > extStateString = stateToString(c, extState, false);
 	
 	// state difference
 	double dist = extStateString.size();
 
 	for (int i=0; i<extStateString.size(); ++i)
-		dist -= similar(extStateString[i], intStateString[i]);
+		dist -= similar(c, extStateString[i], intStateString[i]);
 
-	if (extState == currObservedStates[currObservedStates.size()-1])
+	if (extState == c.currObservedStates[c.currObservedStates.size()-1])
 		hCost = dist * 200;
 	else
 		hCost = dist * 10;
@@ -2338,83 +3341,72 @@ double Imitation::handCode(State& extState, State& intState)
 	Para	: 
 	Return	: string representation of state
 */
-vector<vector<string> > Imitation::stateToString(State state, bool internal)
+vector<vector<string> > Imitation::stateToString(SearchContext& c, const State& state, bool internal)
 {
 	int i;
-	string actor;
-	vector<Object> objs;
+	const Symbol actor = internal ? mapto(Symbol(DEMO), mMap) : Symbol(DEMO);
+	const vector<Object>& objs = internal ? c.intObjects : c.currObservedObjects;
 	
 	vector<string> r;
 	vector<vector<string> > s;
 
-	vector<Relation>::const_iterator iter;
+	State::const_iterator iter;
 	vector<Object>::const_iterator objIter;
-
-	if (internal)
-	{
-		actor = mMap[DEMO];
-		objs = intObjects;	
-	}
-	else
-	{
-		actor = DEMO;
-		objs = currObservedObjects;
-	}
 	
 	for (i=0; i<objs.size(); ++i)
 	{
 		r.clear();
 		// check whether there is a relationship between object and Demo/Imitator in the given state
-		iter = state.findPattern(Relation("?", actor, objs[i].name));
+		iter = state.findPattern(Relation(SYM_WILDCARD, actor, objs[i].name));
 		if (iter == state.end())
 			// not exists, insert four EMPTY string (relation, Demo/Imitator and two attributes)
 			r.insert(r.end(),4, "");
 		else
 		{
-			r.push_back(iter->relation);
-			r.push_back(iter->objA);
+			r.push_back(iter->relation.str());
+			r.push_back(iter->objA.str());
 
 			// object attributes
-			r.push_back(objs[i].color);
-			r.push_back(objs[i].texture);
+			r.push_back(objs[i].color.str());
+			r.push_back(objs[i].texture.str());
 		}
 		s.push_back(r);
 	}
 
 	 // There is special case for Gripper, check if an object on the gripper
-	iter = state.findPattern(Relation("ON", "Gripper", "?"));
+	iter = state.findPattern(Relation(SYM_ON, SYM_GRIPPER, SYM_WILDCARD));
 	r.clear();
-	r.push_back("ON");
-	r.push_back("Gripper");
+	r.push_back(SYM_ON.str());
+	r.push_back(SYM_GRIPPER.str());
 	
-	if (iter == state.end() || iter->objB == "NULL" || 
+	if (iter == state.end() || iter->objB == SYM_NULL || 
 		(objIter = find_if(objs.begin(), objs.end(), sameName<Object>(iter->objB))) == objs.end())
 		// nothing on gripper, two EMPTY string
 		r.insert(r.end(),2, "");
 	else
 	{
 		// find the object attributes
-		r.push_back(objIter->color);
-		r.push_back(objIter->texture);
+		r.push_back(objIter->color.str());
+		r.push_back(objIter->texture.str());
 	}
 	s.push_back(r);
 
 	return s;
 }
 
-double Imitation::similar(const vector<string>& extState, const vector<string>& intState)
+double Imitation::similar(SearchContext& c, const vector<string>& extState, const vector<string>& intState)
 {
 	vector<Object>::iterator objIter;
 
 	// garbage cleaning: check whether the trashcan exists, BLACK PLASTIC
-	if (find(intObjects.begin(), intObjects.end(), Object("?", "BLACK", "PLASTIC")) != intObjects.end() && extState[2] == "GREEN")
+	if (find(c.intObjects.begin(), c.intObjects.end(), Object("?", "BLACK", "PLASTIC")) != c.intObjects.end() && extState[2] == "GREEN")
 	{
 		// ignore the texture for GREEN object		
 		return (extState[0] == intState[0] && extState[2] == intState[2]);
 	}
 
 	// Toy Collection: check whether the ToyCorner exists, BROWN WOOD, need consider different capabilities
-	if (find(intObjects.begin(), intObjects.end(), Object("?", "BROWN", "WOOD"))!= intObjects.end())
+	if (find(c.intObjects.begin(), c.intObjects.end(), Object("?", "BROWN", "WOOD"))!= c.intObjects.end())
 	{
 		if (extState[3] == "PLASTIC")
 			if (extState[0] == "NEXT" && intState[0] == "")
@@ -2434,7 +3426,7 @@ double Imitation::similar(const vector<string>& extState, const vector<string>&
 	}
 
 	// futon match 1, check whether there are color match between object 0 and 2, if yes ignore the texture
-	if (intObjects[0].color == intObjects[2].color)
+	if (c.intObjects[0].color == c.intObjects[2].color)
 	{
 		//cout << "match with futon match"<< endl;		
 		return (extState[0] == intState[0] && extState[2] == intState[2]);
@@ -2449,13 +3441,13 @@ double Imitation::similar(const vector<string>& extState, const vector<string>&
 	Para.	: 
 	Return	: double
 */
-double Imitation::simpleDistance(const State& extState, const State& intState)
+double Imitation::simpleDistance(SearchContext& c, const State& extState, const State& intState)
 {
 	double dist = 0;
 
 	// represent the state with color/texture form in a fix order
-	vector<vector<string> > intSState = stateToString(intState);
-	vector<vector<string> > extSState = stateToString(extState,false);
+	vector<vector<string> > intSState = stateToString(c, intState);
+	vector<vector<string> > extSState = stateToString(c, extState,false);
 	
 	for (int i=0; i<extSState.size(); ++i)
 		for (int j=0; j<extSState[i].size(); ++j)
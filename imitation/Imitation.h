@@ -10,9 +10,17 @@
 #include <algorithm>
 #include <cassert>
 #include <list>
+#include <chrono>
+#include <limits>
+#include <queue>
+#include <cctype>
 
 #include "InternalModel.h"
 #include "InternalState.h"
+#include "SearchContext.h"
+#include "StateLayer.h"
+#include "ThreadPool.h"
+#include "HeapCounter.h"
 #include "FeedForward.h"
 
 #include "Object.h"
@@ -36,20 +44,26 @@ const double MARGIN_PER = 0.3;			//0.6 for fix amount, 0.3 for percentage;
 const double MARGIN = 0.6;
 const double DISCOUNT_FACTOR = 0.995;
 
+const double ARA_INITIAL_WEIGHT = 3.0;	// weight of the heuristic cost in the first anytime search
+const double ARA_WEIGHT_STEP = 0.5;		// decrease of the weight after each policy
+const double DEFAULT_TIME_BUDGET = 0.1;	// time budget of the anytime search, in seconds
+
 // task definition
 enum {TRASH_CLEANING, TOY_COLLECTION, FUTON_MATCH_1, FUTON_MATCH_2};
 
 const string DEMO = "Demo";
 const string NNFILE = "nn.txt";	// neural network's file
 
-// policy & sibling type
-typedef struct pair<vector<Node>, vector<Node> > psType;
-typedef tree_node_<Node> treeNode;
-
 using namespace std;
 
 class Imitation
 {
+	// checks and times the encoders and the network evaluation, see benchmark.cpp
+	friend class EncoderBenchmark;
+
+	// checks the effects of the actions read from actions.txt, see check.cpp
+	friend class EffectCheck;
+
 private:
 	/****************************************** internal variables ****************************************/
 	// the primitive actions
@@ -62,7 +76,6 @@ private:
 	vector<vector<double> > samples;
 	
 	// objects in the internal model
-	vector<Object> intObjects;
 	vector<vector<Object> > imitObjects;
 	
 	// successors generated from current state	
@@ -83,48 +96,91 @@ private:
 	vector<double> expectedOutputs;
 
 	// mapping between the observed state and internal state
-	map<string, string> mMap;
+	map<Symbol, Symbol> mMap;
 
 	// numeric representation of observed state and internal state
-	map<string, double> extNumMap, intNumMap;
+	map<Symbol, double> extNumMap, intNumMap;
 
 	/*********************************** variable and method for A* algorithm *****************************/
-	// open list stores the nodes that have not been expanded, closed list stored the nodes that have been expaned.
-	list<treeNode *> openList, closedList;
-	
-	// current A* tree, only for the current A* search
-	tree<Node> currAStarTree, newAStarTree;
-	
-	psType currPolicySibling;
+	// search context of testing, batch update and the other sequential searches
+	SearchContext ctx;
 
-	/******************************* variables represent external objects **********************************/	
-	// use for exploration
-	Random r;
+	// search context of each training task, one for each new demonstration
+	vector<SearchContext *> taskContexts;
+
+	// search algorithm, ASTAR, REPLAN, BEAM, ANYTIME, IDASTAR or LAYERED
+	int searchType;
+
+	// number of nodes kept on each level by BEAM
+	int beamWidth;
+
+	// time budget of ANYTIME, in seconds
+	double timeBudget;
 
+	// the successors of a state are evaluated from the hidden units' input of the state
+	bool parentEvaluation;
+
+	// the states without a graph or a parent are evaluated from the embedding table of the context
+	bool tableEvaluation;
+
+	// reward lost by BEAM compared to full A* in the tests, and the number of tests
+	double totBeamLoss;
+	int numOfBeamTests;
+
+	// graphs explored by the searches, one for each problem, only used by REPLAN
+	list<SearchGraph> searchGraphs;
+
+	// the training tasks look for their graphs at the same time
+	mutex graphLock;
+
+	// the graph of the current observed model and internal objects, created when it doesn't exist
+	SearchGraph *findSearchGraph(SearchContext& c);
+
+	// the transitions of the internal objects of a context, created when they don't exist
+	TransitionGraph *findTransitionGraph(SearchContext& c);
+
+	// threads which run the training tasks
+	ThreadPool pool;
+
+	// seed of the training tasks' random numbers
+	unsigned long long seed;
+
+	/******************************* variables represent external objects **********************************/	
 	// FeedForward neural network
 	FeedForward nn;
 	int numOfHiddenUnits; 
 
 	// observed mode
 	ObservedModel extModel;
-
-	// current observed model, only contain one demonstration
-	vector<Object> currObservedObjects;
-	vector<State> currObservedStates;
 	
 	/********************************************** Method *************************************************/
 
-	// add a state into a specified list
-	void addToList(list<treeNode*> &target, treeNode *node);
-	void removeFromList(const tree<Node>& aStarTree, treeNode *node);
+	// remove a node and its descendants from the open list and the node table
+	void removeFromList(SearchContext& c, const searchTree& aStarTree, treeNode *node);
 
 	// calculate distance between the observed an mapped state
-	double calcDistance(State extState, State intState, int modelState);	// symbol representation input
-	double calcDistance(vector<double> input);								// numeric representation input
+	double calcDistance(SearchContext& c, const State& extState, const State& intState, int modelState);	// symbol representation input
+	double calcDistance(const vector<double>& input);								// numeric representation input
+	double calcDistance(SearchContext& c, const InternalState& intState, int modelState);		// through the graph of the current search
+
+	// distances of a batch of internal states, the network is evaluated once for all of them
+	void calcDistances(SearchContext& c, const vector<const InternalState *>& states, vector<double>& distances, const InternalState *parent = 0);
+
+	// encode the parent of a batch of successors and keep the network's hidden units' input for it
+	void activate(SearchContext& c, const InternalState& parent);
+
+	// distance drawn from a gaussian distribution around the given mean, used for exploration
+	double randomDistance(SearchContext& c, double mean);
 
 	// convert observed state and internal state into a numeric representation which will be provided to RBF-NN as input
-	vector<double> convert(State extState, State intState);
-	vector<double> convert(State state, bool internal);
+	vector<double> convert(SearchContext& c, const State& extState, const State& intState);
+	void convert(SearchContext& c, const State& extState, const State& intState, double *features);
+
+	// number of numbers in the representation of a state pair of the current problem
+	int numOfFeatures(SearchContext& c);
+
+	// build the encoders and check the distance cache for the current problem of a context
+	void checkProblem(SearchContext& c);
 
 	// base on demonstration generate a set of sample which is used to initialize the neural network, for multiple single-step demonstrations
 	void generateSamples();
@@ -136,7 +192,7 @@ private:
 	void loadMapping(const string fileName);
 
 	// load the numeric representation of observed/internal model
-	map<string, double> loadNumMapping(const string fileName);
+	map<Symbol, double> loadNumMapping(const string fileName);
 
 	// load previous learned demonstrations
 	void load();
@@ -152,37 +208,59 @@ private:
 	void saveLearnedDemos();	// demonstrations just learned
 
 	// set current observed model, always call no matter single or multiple demonstration(s) 
-	void setCurrentObservedModel(const vector<Object> &observedObjects, const vector<State> &observedStates);
-	void setCurrentObservedModel(const vector<Object> &observedObjects, const vector<State> &observedStates, const vector<Object> internalObjects);
+	void setCurrentObservedModel(SearchContext& c, const vector<Object> &observedObjects, const vector<State> &observedStates);
+	void setCurrentObservedModel(SearchContext& c, const vector<Object> &observedObjects, const vector<State> &observedStates, const vector<Object> internalObjects);
 
 	/********************************** Method related to A* algorithm ***********************************/
-	void printTree(fstream &fout,  const tree<Node>& aStarTree, bool standardOutput=false);
-	// using A* algorithm to find a policy
-	psType AStarSearch(int modelState, tree<Node>& aStarTree);
+	void printTree(fstream &fout,  const searchTree& aStarTree, bool standardOutput=false);
+	// using A* algorithm to find a policy, with searchType or the given search algorithm
+	psType AStarSearch(SearchContext& c, int modelState, searchTree& aStarTree);
+	psType AStarSearch(SearchContext& c, int modelState, searchTree& aStarTree, int search);
+
+	// anytime A*, the best policy found within the time budget and its suboptimality bound
+	psType ARAStarSearch(SearchContext& c, int modelState, searchTree& aStarTree, double budget, double &bound);
+
+	// iterative deepening A*, only the current path is kept
+	psType IDAStarSearch(SearchContext& c, int modelState, searchTree& aStarTree);
+	double boundedSearch(SearchContext& c, int modelState, vector<Node>& path, vector<vector<Node> >& levels, 
+		vector<size_t>& chosen, double threshold, bool& found);
+
+	// layer by layer search of the cheapest policy
+	psType layeredSearch(SearchContext& c, int modelState, searchTree& aStarTree);
+	double greedyCost(SearchContext& c, int modelState, const InternalState& start, double g);
+
+	// start a search, expand a node and cleanup after a search, shared by the search algorithms
+	void beginSearch(SearchContext& c, int modelState, searchTree& aStarTree, double weight, int search);
+	void expandNode(SearchContext& c, int modelState, searchTree& aStarTree, treeNode *currState);
+	void generateSuccessors(SearchContext& c, int modelState, InternalState& s, list<InternalState>& successors);
+	void endSearch(SearchContext& c);
+
+	// search the current and a new policy of one demonstration, one training task
+	void searchTask(SearchContext& c, const ObservedModel& demo, unsigned long long taskSeed);
 
 	// get the policy
-	psType getPolicy(const tree<Node>& tree, bool lBackpropagate=true);
+	psType getPolicy(SearchContext& c, const searchTree& tree, bool lBackpropagate=true, treeNode *last=0);
 	
 	// backpropagate heuristic cost
-	void backpropagateHeuristicCost(tree<Node>&);
+	void backpropagateHeuristicCost(searchTree&);
 	void backpropagateHeuristicCost(vector<Node>&);
 	
 	/***************************************** Policy Exploration *******************************************/
 	// do a cost exploration on each successor and reorder them
-	void chooseASuccessor(list<InternalState> &successors);
+	void chooseASuccessor(SearchContext& c, list<InternalState> &successors);
 	
 	// calculate distance from a given policy (mapping the policy back to the distance representation)
 	void batchUpdate(double totRewardDiff);
 
 	// check whether the policy in this internal model is satisfied
-	void generateDistance(InternalModel &intModel, double rewardDiff=0);
+	void generateDistance(SearchContext& c, InternalModel &intModel, double rewardDiff=0);
 	bool policyIsSatisfied(ObservedModel &demo, InternalModel &imit);
 	
 	// add the input/output into training set
-	void addToTrainingSet(const InternalState& state, double expectedOutput, double rewardDiff = 0, double delta = 0);
+	void addToTrainingSet(SearchContext& c, const InternalState& state, double expectedOutput, double rewardDiff = 0, double delta = 0);
 
 	// print A* tree
-	void printNodes(fstream &fout, const vector<Node>& nodes, bool standardOutput=false);
+	void printNodes(SearchContext& c, fstream &fout, const vector<Node>& nodes, bool standardOutput=false);
 
 	/************************************** Miscellaneous Method ******************************************/
 	// load input/expected output from a file
@@ -191,7 +269,7 @@ private:
 	void saveData(string fileName);
 
 	// find the position when found, special purpose
-	int search(vector<vector<double> > &all , vector<double> single);
+	int search(const vector<vector<double> > &all, const vector<double>& single);
 
 	// new and learned demonstration
 	vector<ObservedModel> newDemos, learnedDemos;
@@ -203,9 +281,9 @@ private:
 	vector<int> idxOfCurrImits;
 	
 	// recalculate the distance in the internal model
-	void recalcDistance(InternalModel &intModel);
+	void recalcDistance(SearchContext& c, InternalModel &intModel);
 	// recalculate the distance for a single node
-	void recalcDistance(Node &node, double gOfParent);
+	void recalcDistance(SearchContext& c, Node &node, double gOfParent, double newDistance);
 	
 	// calculate action's cost given its num
 	double calcActionCost(int num);
@@ -214,26 +292,26 @@ private:
 	fstream fout_update, fout_policy, fout_err, fout_rew, fout_oldRew;
 
 	// calculate reward for different task
-	double calcReward(vector<Node> &policy, int numOfDemo = -1);
+	double calcReward(SearchContext& c, vector<Node> &policy, int numOfDemo = -1);
 	
-	double calcReward(State state);
-	double calcRewardForCleaning(State state);
-	double calcRewardForCollection(State state);
-	double calcRewardForDoubleDrop(State state);
+	double calcReward(SearchContext& c, const State& state);
+	double calcRewardForCleaning(const State& state);
+	double calcRewardForCollection(SearchContext& c, const State& state);
+	double calcRewardForDoubleDrop(const State& state);
 
-	void changeImitationEnvironment(int numOfDemo, int idxOfAttr = -1);
+	void changeImitationEnvironment(SearchContext& c, int numOfDemo, int idxOfAttr = -1);
 	void clearTrainingSet();
 
 	// check whether the given state is goal state
-	bool isGoalState(const InternalState& intState);
-	double calcHeuristicCost(const InternalState& intState);
+	bool isGoalState(SearchContext& c, const InternalState& intState);
+	double calcHeuristicCost(SearchContext& c, const InternalState& intState);
 
 	// another version of calculate the distance between observed state and internal state, comparing with neural network
-	double handCode(State& extState, State& intState);
-	vector<vector<string> > stateToString(State state, bool internal=true);
+	double handCode(SearchContext& c, const State& extState, const State& intState);
+	vector<vector<string> > stateToString(SearchContext& c, const State& state, bool internal=true);
 
-	double similar(const vector<string>& extState, const vector<string>& intState);
-	double minMax(tree<Node>& aStarTree, tree<Node>::iterator_base&);
+	double similar(SearchContext& c, const vector<string>& extState, const vector<string>& intState);
+	double minMax(searchTree& aStarTree, searchTree::iterator_base&);
 	
 	void testAction(State& s, int iAction, string p1, string p2="");
 
@@ -246,7 +324,10 @@ private:
 	void test_N(int modelState, fstream &fout);
 	void test_new(int modelState, fstream &fout);
 
-	double simpleDistance(const State& extState, const State& intState);
+	// search the current problem with full A* too and report the reward lost by the beam search
+	void compareWithAStar(int modelState, double reward, int numOfDemo, fstream &fout);
+
+	double simpleDistance(SearchContext& c, const State& extState, const State& intState);
 public:
 	Imitation(int numOfHidden = 10, bool debugModel = false);
 	~Imitation(void);
@@ -259,6 +340,34 @@ public:
 		HANDCODE_EW		// hand-coded with equal weight
 	};
 
+	// search algorithm
+	enum {
+		ASTAR,			// A* search from scratch
+		REPLAN,			// A* search which reuses the graph explored by earlier searches of the same problem
+		BEAM,			// A* search which keeps only the best beamWidth nodes on each level of the tree
+		ANYTIME,		// anytime A* (ARA*), the best policy found within timeBudget
+		IDASTAR,		// iterative deepening A*, memory bounded by the length of the policy
+		LAYERED			// dynamic programming over the observed states, the cheapest policy
+	};
+
+	// choose the search algorithm, ASTAR by default
+	void setSearch(int searchTypeVal, int beamWidthVal = DEFAULT_BEAM_WIDTH);
+
+	// time budget of each search for ANYTIME, in seconds
+	void setTimeBudget(double seconds);
+
+	// evaluate the successors of a state from the hidden units' input of the state, off by default
+	// it differs from the full evaluation by rounding, so the training isn't reproduced exactly
+	void setParentEvaluation(bool on);
+
+	// evaluate the states without a graph or a parent from the embedding table of the slot values, off by default
+	// it differs from the full evaluation by rounding as well
+	void setTableEvaluation(bool on);
+
+	// number of threads the training tasks run on and the seed of their random numbers
+	// by default the tasks run one after another on the calling thread with the seed 0
+	void setParallel(int numOfThreads, unsigned long long seedVal);
+
 
 	// update the network to produce optimal policy for given demonstration
 	void training();
@@ -279,9 +388,9 @@ public:
 	// Nonmember functions
 
 	// map object, relation, state into internal representation
-	Object mapping(const Object& o, map<string, string>& m);
-	Relation mapping(const Relation& r, map<string, string>& m);
-	State mapping(State s, map<string,string>& m);
+	Object mapping(const Object& o, const map<Symbol, Symbol>& m);
+	Relation mapping(const Relation& r, const map<Symbol, Symbol>& m);
+	State mapping(const State& s, const map<Symbol,Symbol>& m);
 	
 	// create object from input
 	Object readObject(fstream &fin);
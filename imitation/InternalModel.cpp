@@ -1,10 +1,10 @@
 #include "InternalModel.h"
 
-Node::Node(void) {}
+Node::Node(void) : openPos(-1), closed(false) {}
 Node::~Node(void) {}
 
 Node::Node(InternalState stateVal, int levelVal, double gVal, double hVal)
-: state(stateVal), level(levelVal), g(gVal), h(hVal)
+: state(move(stateVal)), level(levelVal), g(gVal), h(hVal), openPos(-1), closed(false)
 {
 	f = g + h;
 }
@@ -15,16 +15,16 @@ string Node::toString() const
 	return convertToString(level) + " " + convertToString(h) + "\n" + state.toString(); 
 }
 
-bool Node::operator==(const Node &node)
+bool Node::operator==(const Node &node) const
 {
 	return (state==node.state);
 }
 
-bool Node::operator!=(const Node &node)
+bool Node::operator!=(const Node &node) const
 {
 	return (state!=node.state);
 }
-bool Node::operator<(const Node node)
+bool Node::operator<(const Node &node) const
 {
 	return (level<node.level || (level==node.level && f<node.f));
 }
@@ -34,7 +34,7 @@ InternalModel::InternalModel(void) {}
 InternalModel::~InternalModel(void) {}
 
 InternalModel::InternalModel(vector<Object> objectsVal, vector<Node> policyVal, vector<Node> siblingsVal, double rewardVal)
-: policy(policyVal), siblings(siblingsVal), objects(objectsVal), reward(rewardVal) {}
+: policy(move(policyVal)), siblings(move(siblingsVal)), objects(move(objectsVal)), reward(rewardVal) {}
 
 string InternalModel::toString() const
 {
@@ -16,15 +16,23 @@ class Node
 		double h;			// the estimate cost of getting from this instance to the goal node.
 		double f;			// total cost, g+h
 
+		int openPos;		// position on the open list, -1 when it is not on the list
+		bool closed;		// whether this instance has been expanded
+
 		Node(void);
 		Node(InternalState stateVal, int levelVal, double gVal, double hVal);
 
 		~Node(void);
 
+		Node(const Node& node) = default;
+		Node(Node&& node) = default;
+		Node& operator=(const Node& node) = default;
+		Node& operator=(Node&& node) = default;
+
 		string toString() const;
-		bool operator==(const Node &node);
-		bool operator!=(const Node &node);
-		bool operator<(const Node node);
+		bool operator==(const Node &node) const;
+		bool operator!=(const Node &node) const;
+		bool operator<(const Node &node) const;
 };
 
 class InternalModel
@@ -40,6 +48,11 @@ public:
 
 	~InternalModel(void);
 
+	InternalModel(const InternalModel& m) = default;
+	InternalModel(InternalModel&& m) = default;
+	InternalModel& operator=(const InternalModel& m) = default;
+	InternalModel& operator=(InternalModel&& m) = default;
+
 	string toString() const;
 };
 #endif
@@ -2,7 +2,9 @@
 #define INTERNALSTATE_H
 
 #include "State.h"
+#include "SharedState.h"
 #include "Action.h"
+#include "ActionTable.h"
 #include "Utility.h"
 #include "Object.h"
 
@@ -11,30 +13,32 @@ using namespace std;
 
 class InternalState
 {
-	// generate the successors base on current state and one action
-	list<InternalState> genASuccessor(Action action, string p1, string p2);
-
 public:
 	int action;			// action taken at previous states that end up with this instance
-	State state;		// internal state
+	SharedState state;	// internal state, shared with the internal states and nodes holding the same relations
 	int extStateNum;	// corresponding observed state
 	double distance;	// distance between observed state and internal state
 
 	InternalState(void);
-	InternalState(int actionVal, State stateVal, int extStateNumVal, double distanceVal=0);
+	InternalState(int actionVal, SharedState stateVal, int extStateNumVal, double distanceVal=0);
 
 	~InternalState(void);
 
+	InternalState(const InternalState& s) = default;
+	InternalState(InternalState&& s) = default;
+	InternalState& operator=(const InternalState& s) = default;
+	InternalState& operator=(InternalState&& s) = default;
+
 	// clear this instance
 	void clear();
 
-	// generate all the possible successors base on current state and primitive action
-	list<InternalState> genSuccessors(vector<Action> actions, vector<Object> intObjects);
+	// generate all the possible successors base on current state and the grounded actions
+	list<InternalState> genSuccessors(const ActionTable& table) const;
 
 	// check whether the given state is equal to this instance, state and extStateNum comparison
-	bool operator==(InternalState s);
-	bool operator!=(InternalState s);
-	bool operator<(InternalState& s);
+	bool operator==(const InternalState& s) const;
+	bool operator!=(const InternalState& s) const;
+	bool operator<(const InternalState& s) const;
 	
 	// Returns a String that represents this instance
 	string toString() const;
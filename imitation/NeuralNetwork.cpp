@@ -1,8 +1,34 @@
 #include "NeuralNetwork.h"
 
-NeuralNetwork::NeuralNetwork(void) {}
+NeuralNetwork::NeuralNetwork(void) : numOfPara(0), weights(0), gradients(0), version(0) {}
 NeuralNetwork::~NeuralNetwork(void) {}
 
+// first aligned position of a storage of n numbers plus the alignment
+static double *alignedBlock(vector<double>& storage, int n)
+{
+	const size_t extra = PARAMETER_ALIGNMENT / sizeof(double);
+	size_t offset;
+
+	storage.assign(n + extra, 0.0);
+	offset = (PARAMETER_ALIGNMENT - (size_t)&storage[0] % PARAMETER_ALIGNMENT) % PARAMETER_ALIGNMENT / sizeof(double);
+
+	return &storage[0] + offset;
+}
+
+/*
+	Function: allocate()
+	Desc	: allocate the blocks of the parameters and of their gradient
+	Para	: numOfParaVal, number of parameters
+	Return	: None
+	Note	: each block starts on a PARAMETER_ALIGNMENT boundary, so the loops over them can be vectorized
+*/
+void NeuralNetwork::allocate(int numOfParaVal)
+{
+	numOfPara = numOfParaVal;
+	weights = alignedBlock(weightStorage, numOfPara);
+	gradients = alignedBlock(gradientStorage, numOfPara);
+}
+
 /*
 	Function: scaledConjugateGradient()
 	Desc	: Scaled Conjugate Gradient algorithm
@@ -40,8 +66,8 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 
 	time_t startTime = time(NULL);
 
-	// store the address of all the weight factors and gradient descent into a vector
-	getWeights();
+	// the weights are going to change
+	++version;
 
 	oldWeight = new double[numOfPara];
 	oldGradient = new double[numOfPara];
@@ -65,7 +91,7 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 	normR = 0;
 	for (i=0; i<numOfPara; ++i)
 	{
-		p[i]=- *gradientAddr[i];
+		p[i]=-gradients[i];
 		r[i]=p[i];
 	
 		// calculate l2-Norm of p, r
@@ -133,8 +159,8 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 		// store current gradient descent and weight factor
 		for (i=0; i<numOfPara; ++i)
 		{
-			oldGradient[i]= *gradientAddr[i];
-			oldWeight[i]= *weightAddr[i];
+			oldGradient[i]=gradients[i];
+			oldWeight[i]=weights[i];
 		}	
 		oldErr=err;
 
@@ -149,7 +175,7 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 
 			// calculate new weight base on p and sigma
 			for (i=0; i<numOfPara; ++i)
-				*weightAddr[i] += sigma * p[i];
+				weights[i] += sigma * p[i];
 
 			// calculate gradient descent (first order deviation)
 			err = calcGradientDescent(inputs, expectedOutputs);
@@ -157,7 +183,7 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 			delta = 0;
 			for (i=0; i<numOfPara; ++i)
 			{
-				s[i]=(*gradientAddr[i]-oldGradient[i])/sigma;
+				s[i]=(gradients[i]-oldGradient[i])/sigma;
 				delta += p[i]*s[i];
 			}
 
@@ -194,7 +220,7 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 		// 6. calculate the comparison parameter
 		// change weight factor first, if not accept, roll back
 		for (i=0; i<numOfPara; ++i)
-			*weightAddr[i] = oldWeight[i] + alpha*p[i];
+			weights[i] = oldWeight[i] + alpha*p[i];
 
 		// calculate gradient descent, main purpose is to calculate err
 		err = calcGradientDescent(inputs, expectedOutputs);
@@ -221,10 +247,10 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 			for (i=0; i<numOfPara; ++i)
 			{
 				// calculate the dot product of previous r and current one.
-				dotProductOfRPreR += - *gradientAddr[i] * r[i];
+				dotProductOfRPreR += -gradients[i] * r[i];
 
 				// update r and calculate dot product of r
-				r[i]=- *gradientAddr[i];
+				r[i]=-gradients[i];
 				dotProductOfRR += r[i]*r[i];
 			}
 			normR = sqrt(dotProductOfRR);
@@ -263,7 +289,7 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 			
 			// undo the change made in previous step (step 6)
 			for (i=0; i<numOfPara; ++i)
-				*weightAddr[i] = oldWeight[i];
+				weights[i] = oldWeight[i];
 			err=oldErr;
 
 			lambdaRaised = lambda;
@@ -277,9 +303,6 @@ double NeuralNetwork::scaledConjugateGradient(vector<vector<double> > &inputs, v
 		oldNormSqrP = normSqrP;
 	}
 
-	delete [] weightAddr;
-	delete [] gradientAddr;
-
 	delete [] oldWeight;
 	delete [] oldGradient;
 	delete [] p;
@@ -311,3 +334,8 @@ double NeuralNetwork::calcDotProduct(double *x, double *y)
 
 	return sum;
 }
+
+long NeuralNetwork::getVersion() const
+{
+	return version;
+}
@@ -19,32 +19,37 @@ const int MAX_TIME = 120;			//120s, 2 min
 const double MIN_GRAD = 1e-6;
 const int MAX_FAIL_REDUCTION = 10;	// when the number of consecutive zero reduction reach this maximum, stop training
 const int SHOW = 100;
+const int PARAMETER_ALIGNMENT = 64;	// bytes, the parameter blocks start on a cache line
 
 class NeuralNetwork
 {
 private:
 	/****************** Virtual Function Definition **************************/
 	// Transfer function on hidden unit
-	virtual double calcHiddenTrans(double x) = 0;
+	virtual double calcHiddenTrans(double x) const = 0;
 
 	// calculate derivative of hidden unit i
 	virtual double calcHiddenDerivative(int i) = 0;
 
 	// Transfer function on output unit
-	virtual double calcOutputTrans(double x) = 0;
+	virtual double calcOutputTrans(double x) const = 0;
 
 	// calculate gradient upon weight and bias
 	virtual double calcGradientDescent(vector<vector<double> > &inputs, vector<double> &expectedOutputs)=0;
 
-	// store address of weights and their gradient into a vector
-	virtual void getWeights()=0;
-	
 	// save network
 	virtual void save(fstream &fout)=0;
 
 	/***************** Miscellaneous Function Definition ********************/ 
 	double calcDotProduct(double *x, double *y);
 
+	// storage of the parameter blocks, larger than them by the alignment
+	vector<double> weightStorage, gradientStorage;
+
+	// the blocks point into the storage, copies would point into the original
+	NeuralNetwork(const NeuralNetwork&);
+	void operator=(const NeuralNetwork&);
+
 protected: 
 	// follwing variables can be accessed by all the derived class
 		
@@ -57,11 +62,15 @@ protected:
 	// hidden unit's input and output
 	vector<double>  hInput, hOutput;
 
-	// a vector which store the address of weight factor
-	double* *weightAddr;
+	// all the weight factors and biases in one block, and their gradient at the same positions in another,
+	// numOfPara numbers each. The derived class decides the layout of the block and keeps views into it
+	double *weights, *gradients;
+
+	// allocate both blocks for the given number of parameters, all 0
+	void allocate(int numOfParaVal);
 
-	// a vector which store the address of gradient descent
-	double* *gradientAddr;
+	// increased whenever the weights change, so outputs computed earlier can be recognized as stale
+	long version;
 
 public:
 	// expected reward
@@ -79,6 +88,15 @@ public:
 	// calculate output of neural network
 	virtual double calcOutput(vector<double> &x)=0;
 
+	// calculate output of neural network without keeping the hidden units' input/output, can be called concurrently
+	virtual double evaluate(const vector<double> &x) const=0;
+
+	// calculate outputs of a batch of inputs, x holds numOfRows inputs one after another
+	virtual void evaluate(const double *x, int numOfRows, double *outputs) const=0;
+
 	double scaledConjugateGradient(vector<vector<double> > &inputs, vector<double> &expectedOutputs, double goal, int numOfIteration = MAX_EPOCHES);
+
+	// version of the current weights
+	long getVersion() const;
 };
 #endif
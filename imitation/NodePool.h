@@ -0,0 +1,198 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <cassert>
+
+using namespace std;
+
+// number of blocks taken from the heap at once
+#define POOL_CHUNK_SIZE 256
+
+/*
+	Arena of fixed size blocks for the nodes of one A* tree.
+	Blocks are carved out of large chunks one after another. A search builds its tree from scratch,
+	so once the old tree is cleared, release() gives back all its blocks at once and the next search
+	carves the same chunks again from the start, in the order its nodes are created. The chunks only
+	go back to the heap with the pool, so after the first searches a search doesn't go to the heap.
+	Nodes erased during a search are kept on a free list until the release, so a search which
+	replaces many nodes doesn't keep growing the arena.
+	Each search context has its own pools, and a context is searched by one thread at a time, so
+	the pools don't take a lock.
+*/
+template <class T>
+class NodePool
+{
+	union Block
+	{
+		Block *next;
+		alignas(T) char data[sizeof(T)];
+	};
+
+	vector<Block *> chunks;
+	Block *freeList;
+
+	// chunk the blocks are carved from and its blocks which haven't been handed out
+	size_t current;
+	Block *unused, *unusedEnd;
+
+	// where release() goes back to, see mark()
+	size_t markChunk;
+	Block *markUnused;
+	long markInUse;
+
+	// the trees refer to their pool
+	NodePool(const NodePool&);
+	void operator=(const NodePool&);
+
+public:
+	// counters, allocations is the number of blocks handed out, chunkAllocations the number of heap allocations
+	long allocations, chunkAllocations, inUse, peak;
+
+	NodePool(void) : freeList(0), current(0), unused(0), unusedEnd(0), markChunk(0), markUnused(0), markInUse(0), 
+		allocations(0), chunkAllocations(0), inUse(0), peak(0) {}
+
+	~NodePool(void)
+	{
+		for (size_t i=0; i<chunks.size(); ++i)
+			::operator delete(chunks[i]);
+	}
+
+	/*
+		Function: allocate()
+		Desc.	: get one block, from the free list first, then from the current chunk, then from the next one
+		Para.	: None
+		Return	: uninitialized memory for one T
+	*/
+	T *allocate()
+	{
+		Block *b;
+
+		if (freeList != 0)
+		{
+			b = freeList;
+			freeList = b->next;
+		}
+		else
+		{
+			if (unused == unusedEnd)
+			{
+				// the chunks after the current one are left from the earlier searches
+				size_t next = (unused == 0) ? 0 : current+1;
+				if (next == chunks.size())
+				{
+					chunks.push_back(static_cast<Block *>(::operator new(POOL_CHUNK_SIZE * sizeof(Block))));
+					++chunkAllocations;
+				}
+				current = next;
+				unused = chunks[current];
+				unusedEnd = unused + POOL_CHUNK_SIZE;
+			}
+			b = unused++;
+		}
+
+		++allocations;
+		if (++inUse > peak)
+			peak = inUse;
+
+		return reinterpret_cast<T *>(b->data);
+	}
+
+	// give one block back to the pool, it is handed out again before the next release()
+	void deallocate(T *p)
+	{
+		Block *b = reinterpret_cast<Block *>(p);
+
+		b->next = freeList;
+		freeList = b;
+		--inUse;
+	}
+
+	// the blocks handed out so far are kept by release(), for the blocks a tree holds while it is empty
+	void mark()
+	{
+		markChunk = current;
+		markUnused = unused;
+		markInUse = inUse;
+	}
+
+	/*
+		Function: release()
+		Desc.	: give back all the blocks handed out since mark() at once
+		Para.	: None
+		Return	: None
+		Note	: the tree has to be cleared first, none of those blocks may be in use
+	*/
+	void release()
+	{
+		assert(inUse == markInUse);
+
+		freeList = 0;
+		current = markChunk;
+		unused = markUnused;
+		unusedEnd = (unused == 0) ? 0 : chunks[current] + POOL_CHUNK_SIZE;
+		inUse = markInUse;
+	}
+
+	// reset the counters, the blocks are kept
+	void resetCounters()
+	{
+		allocations = 0;
+		chunkAllocations = 0;
+		peak = inUse;
+	}
+};
+
+/*
+	Allocator for tree<>, single objects come from the given NodePool. Without a pool it uses the heap.
+*/
+template <class T>
+class PoolAllocator
+{
+	NodePool<T> *pool;
+
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <class U> struct rebind { typedef PoolAllocator<U> other; };
+
+	PoolAllocator(void) : pool(0) {}
+	explicit PoolAllocator(NodePool<T> *poolVal) : pool(poolVal) {}
+	template <class U> PoolAllocator(const PoolAllocator<U>&) : pool(0) {}
+
+	T *allocate(size_t n, const void * =0)
+	{
+		if (n == 1 && pool != 0)
+			return pool->allocate();
+
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+
+	void deallocate(T *p, size_t n)
+	{
+		if (n == 1 && pool != 0)
+			pool->deallocate(p);
+		else
+			::operator delete(p);
+	}
+
+	// start the pool over, see NodePool::release()
+	void release() const
+	{
+		if (pool != 0)
+			pool->release();
+	}
+
+	bool operator==(const PoolAllocator& other) const { return pool == other.pool; }
+	bool operator!=(const PoolAllocator& other) const { return pool != other.pool; }
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "NodeTable.h"
+
+NodeTable::NodeTable(void) {}
+NodeTable::~NodeTable(void) {}
+
+/*
+	Function: key()
+	Desc.	: hash key of an internal state, combines the state and the corresponding observed state
+	Para.	: s, an internal state
+	Return	: size_t
+*/
+size_t NodeTable::key(const InternalState& s)
+{
+	return s.state->hash() ^ mixHash(s.extStateNum);
+}
+
+void NodeTable::clear()
+{
+	table.clear();
+}
+
+size_t NodeTable::size() const
+{
+	return table.size();
+}
+
+/*
+	Function: insert()
+	Desc.	: register a node of the A* tree
+	Para.	: node, a tree node
+	Return	: None
+*/
+void NodeTable::insert(treeNode *node)
+{
+	table.insert(make_pair(key(node->data.state), node));
+}
+
+/*
+	Function: erase()
+	Desc.	: unregister a node of the A* tree
+	Para.	: node, a tree node
+	Return	: None
+*/
+void NodeTable::erase(treeNode *node)
+{
+	pair<unordered_multimap<size_t, treeNode *>::iterator, unordered_multimap<size_t, treeNode *>::iterator> range;
+
+	range = table.equal_range(key(node->data.state));
+	for (; range.first != range.second; ++range.first)
+		if (range.first->second == node)
+		{
+			table.erase(range.first);
+			return;
+		}
+}
+
+/*
+	Function: find()
+	Desc.	: look for the tree node which has the same internal state as the given node
+	Para.	: node, the node to look for
+	Return	: the tree node, 0 when not found
+*/
+treeNode *NodeTable::find(const Node& node) const
+{
+	pair<unordered_multimap<size_t, treeNode *>::const_iterator, unordered_multimap<size_t, treeNode *>::const_iterator> range;
+
+	range = table.equal_range(key(node.state));
+	for (; range.first != range.second; ++range.first)
+		if (range.first->second->data == node)
+			return range.first->second;
+
+	return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef NODETABLE_H
+#define NODETABLE_H
+
+#include <unordered_map>
+
+#include "OpenList.h"
+
+using namespace std;
+
+/*
+	Transposition table of the A* tree, maps an internal state (state and corresponding observed state)
+	to the tree node that holds it, so duplicate nodes are found without walking the tree.
+*/
+class NodeTable
+{
+	unordered_multimap<size_t, treeNode *> table;
+
+	// hash key of an internal state
+	static size_t key(const InternalState& s);
+
+public:
+	NodeTable(void);
+	~NodeTable(void);
+
+	// remove all the entries
+	void clear();
+
+	// register/unregister a node of the A* tree
+	void insert(treeNode *node);
+	void erase(treeNode *node);
+
+	// the tree node whose internal state is equal to the given node's, 0 when there is none
+	treeNode *find(const Node& node) const;
+
+	size_t size() const;
+};
+
+#endif
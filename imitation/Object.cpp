@@ -1,16 +1,34 @@
 #include "Object.h"
 
-Object::Object(string nameVal, string colorVal, string textureVal) : 
+Object::Object(Symbol nameVal, Symbol colorVal, Symbol textureVal) : 
 	name(nameVal), color(colorVal), texture(textureVal) {}
 
 Object::~Object(void){}
 
 string Object::toString() const
 {
-	return name + " " + color + " " + texture + "\n";
+	return name.str() + " " + color.str() + " " + texture.str() + "\n";
 }
 
 bool Object::operator==(const Object& o) const
 {
-	return ((o.name == "?" || name==o.name) && (o.color == "?" || color==o.color) && (o.texture == "?" || texture ==o.texture));
-}
\ No newline at end of file
+	return ((o.name.isWildcard() || name==o.name) && (o.color.isWildcard() || color==o.color) && (o.texture.isWildcard() || texture ==o.texture));
+}
+
+/*
+	Function: sameObjects()
+	Desc.	: compare two sets of objects, name, color and texture must be exactly the same
+	Para.	: a, b, two sets of objects
+	Return	: bool
+*/
+bool sameObjects(const vector<Object>& a, const vector<Object>& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i=0; i<a.size(); ++i)
+		if (a[i].name != b[i].name || a[i].color != b[i].color || a[i].texture != b[i].texture)
+			return false;
+
+	return true;
+}
@@ -2,17 +2,20 @@
 #define OBJECT_H
 
 #include <string>
+#include <vector>
 #include <functional>
 
+#include "Symbol.h"
+
 using namespace std;
 class Object
 {
 public:
-	string name;
-	string color;
-	string texture;
+	Symbol name;
+	Symbol color;
+	Symbol texture;
 
-	Object(string nameVal="", string colorVal="", string textureVal="");
+	Object(Symbol nameVal=Symbol(), Symbol colorVal=Symbol(), Symbol textureVal=Symbol());
 
 	~Object(void);
 
@@ -21,4 +24,7 @@ public:
 
 	string toString() const;
 };
+
+// compare two sets of objects, name, color and texture must be exactly the same (no wildcard)
+bool sameObjects(const vector<Object>& a, const vector<Object>& b);
 #endif
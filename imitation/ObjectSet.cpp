@@ -0,0 +1,154 @@
+#include "ObjectSet.h"
+
+#include <bitset>
+#include <vector>
+#include <algorithm>
+
+ObjectSet::ObjectSet(void) {}
+
+bool ObjectSet::contains(const Symbol& obj) const
+{
+	const size_t w = obj.num() / 64;
+
+	return w < words.size() && (words[w] >> (obj.num() % 64) & 1) != 0;
+}
+
+/*
+	Function: add()
+	Desc.	: add an object to this instance
+	Para.	: obj, the object
+	Return	: None
+	Note	: an object which is already a member is kept in repeats, as the list this replaces had it twice
+*/
+void ObjectSet::add(const Symbol& obj)
+{
+	const size_t w = obj.num() / 64;
+
+	if (contains(obj))
+	{
+		repeats.push_back(obj);
+		return;
+	}
+
+	while (words.size() <= w)
+		words.push_back(0);
+
+	words[w] |= 1ULL << (obj.num() % 64);
+}
+
+/*
+	Function: remove()
+	Desc.	: remove one copy of an object from this instance
+	Para.	: obj, the object
+	Return	: None
+*/
+void ObjectSet::remove(const Symbol& obj)
+{
+	Symbol *p = find(repeats.begin(), repeats.end(), obj);
+
+	if (p != repeats.end())
+		repeats.erase(p);
+	else if (contains(obj))
+		words[obj.num() / 64] &= ~(1ULL << (obj.num() % 64));
+}
+
+int ObjectSet::size() const
+{
+	size_t n = repeats.size();
+
+	for (size_t i=0; i<words.size(); ++i)
+		n += bitset<64>(words[i]).count();
+
+	return (int)n;
+}
+
+bool ObjectSet::empty() const
+{
+	return size() == 0;
+}
+
+void ObjectSet::clear()
+{
+	words.clear();
+	repeats.clear();
+}
+
+/*
+	Function: next()
+	Desc.	: walk through the members in the order of their numbers
+	Para.	: num, number of the last member seen, -1 to get the first one
+	Return	: number of the next member, -1 when there is none
+*/
+int ObjectSet::next(int num) const
+{
+	size_t w = (num + 1) / 64;
+	unsigned long long bits;
+
+	if (w >= words.size())
+		return -1;
+
+	// the bits of the members after num in the first word
+	bits = words[w] >> ((num + 1) % 64);
+	num = num + 1;
+
+	for (;;)
+	{
+		for (; bits != 0; bits >>= 1, ++num)
+			if ((bits & 1) != 0)
+				return num;
+
+		if (++w >= words.size())
+			return -1;
+
+		bits = words[w];
+		num = (int)w * 64;
+	}
+}
+
+/*
+	Function: operator==()
+	Desc.	: check whether the given set has the same members
+	Para.	: s, the set that is compared
+	Return	: bool
+	Note	: missing words are zero, the repeats are compared as multisets
+*/
+bool ObjectSet::operator==(const ObjectSet& s) const
+{
+	const size_t n = max(words.size(), s.words.size());
+	vector<Symbol> a, b;
+
+	for (size_t i=0; i<n; ++i)
+		if ((i < words.size() ? words[i] : 0) != (i < s.words.size() ? s.words[i] : 0))
+			return false;
+
+	if (repeats.size() != s.repeats.size())
+		return false;
+
+	if (repeats.empty())
+		return true;
+
+	a.assign(repeats.begin(), repeats.end());
+	b.assign(s.repeats.begin(), s.repeats.end());
+	sort(a.begin(), a.end());
+	sort(b.begin(), b.end());
+
+	return a == b;
+}
+
+bool ObjectSet::operator!=(const ObjectSet& s) const
+{
+	return !(*this == s);
+}
+
+string ObjectSet::toString() const
+{
+	string s = "";
+
+	for (int n = next(-1); n != -1; n = next(n))
+		s += Symbol::at(n).str() + " ";
+
+	for (size_t i=0; i<repeats.size(); ++i)
+		s += repeats[i].str() + " ";
+
+	return s;
+}
@@ -0,0 +1,54 @@
+#ifndef OBJECTSET_H
+#define OBJECTSET_H
+
+#include <string>
+
+#include "Symbol.h"
+#include "SmallVector.h"
+
+using namespace std;
+
+/*
+	A set of objects kept as bits indexed by the number of their symbol, used for the objects next to
+	each other in a state. Checking, adding and removing an object are bit operations instead of
+	searches in a list of names. The first 64 symbols fit in the word kept inside the instance.
+	The list of objects this replaces could hold an object twice (PUSH adds the object pushed toward
+	again), and its size decided when the list was emptied, so an object added while it is a member
+	is kept in repeats and counted by size(), and remove() takes the repeated copy first.
+*/
+class ObjectSet
+{
+	SmallVector<unsigned long long, 1> words;
+	SmallVector<Symbol, 2> repeats;			// members added again, empty in practice
+
+public:
+	ObjectSet(void);
+
+	// check whether an object is a member
+	bool contains(const Symbol& obj) const;
+
+	// add an object, a member is added again
+	void add(const Symbol& obj);
+
+	// remove one copy of an object, nothing happens when it isn't a member
+	void remove(const Symbol& obj);
+
+	// number of objects, counting the repeated ones
+	int size() const;
+	bool empty() const;
+
+	void clear();
+
+	// the member with the smallest number above the given number, -1 for the first one,
+	// returns -1 after the last one
+	int next(int num) const;
+
+	// same members, repeats included, in any order
+	bool operator==(const ObjectSet& s) const;
+	bool operator!=(const ObjectSet& s) const;
+
+	// names of the members separated by spaces
+	string toString() const;
+};
+
+#endif
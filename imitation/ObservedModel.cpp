@@ -4,7 +4,7 @@ ObservedModel::ObservedModel(void) {}
 ObservedModel::~ObservedModel(void) {}
 
 ObservedModel::ObservedModel(int numVal, vector<Object> objectsVal, vector<State> statesVal)
-: num(numVal), objects(objectsVal), states(statesVal) {}
+: num(numVal), objects(move(objectsVal)), states(move(statesVal)) {}
 
 /*
 	Function: toString()
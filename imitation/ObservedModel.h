@@ -19,6 +19,11 @@ public:
 	ObservedModel(int numVal, vector<Object> objectsVal, vector<State> statesVal);
 
 	~ObservedModel(void);
+
+	ObservedModel(const ObservedModel& m) = default;
+	ObservedModel(ObservedModel&& m) = default;
+	ObservedModel& operator=(const ObservedModel& m) = default;
+	ObservedModel& operator=(ObservedModel&& m) = default;
 	
 	// return a string representing this instance
 	string toString() const;
@@ -0,0 +1,212 @@
+#include "OpenList.h"
+
+#include <cmath>
+
+OpenList::OpenList(void) : frontSeq(0), backSeq(0) {}
+OpenList::~OpenList(void) {}
+
+/*
+	Function: clear()
+	Desc.	: remove all the nodes from the open list
+	Para.	: None
+	Return	: None
+*/
+void OpenList::clear()
+{
+	for (size_t i=0; i<heap.size(); ++i)
+		heap[i].node->data.openPos = -1;
+
+	heap.clear();
+	frontSeq = 0;
+	backSeq = 0;
+}
+
+bool OpenList::empty() const
+{
+	return heap.empty();
+}
+
+size_t OpenList::size() const
+{
+	return heap.size();
+}
+
+void OpenList::getNodes(vector<treeNode *>& nodes) const
+{
+	nodes.clear();
+	for (size_t i=0; i<heap.size(); ++i)
+		nodes.push_back(heap[i].node);
+}
+
+bool OpenList::contains(const treeNode *node) const
+{
+	return node->data.openPos != -1;
+}
+
+treeNode *OpenList::front() const
+{
+	return heap.empty() ? 0 : heap[0].node;
+}
+
+/*
+	Function: pop()
+	Desc.	: remove the node with the lowest key from the open list
+	Para.	: None
+	Return	: the node removed, 0 when the list is empty
+*/
+treeNode *OpenList::pop()
+{
+	treeNode *node = front();
+
+	if (node != 0)
+		remove(node);
+
+	return node;
+}
+
+/*
+	Function: push()
+	Desc.	: add a node into the open list, its position is based on the key
+	Para.	: node, a node in the A* tree
+			  key, the node's priority, usually its total cost f
+	Return	: None
+	Note	: the node is placed behind the nodes with the same key
+*/
+void OpenList::push(treeNode *node, double key)
+{
+	insert(node, key, ++backSeq);
+}
+
+/*
+	Function: pushFront()
+	Desc.	: add a node ahead of all the nodes on the open list
+	Para.	: node, a node in the A* tree
+	Return	: None
+*/
+void OpenList::pushFront(treeNode *node)
+{
+	insert(node, -HUGE_VAL, --frontSeq);
+}
+
+/*
+	Function: pushBack()
+	Desc.	: add a node behind all the nodes on the open list
+	Para.	: node, a node in the A* tree
+	Return	: None
+*/
+void OpenList::pushBack(treeNode *node)
+{
+	insert(node, HUGE_VAL, ++backSeq);
+}
+
+/*
+	Function: remove()
+	Desc.	: remove a node from the open list
+	Para.	: node, a node in the A* tree
+	Return	: None
+*/
+void OpenList::remove(treeNode *node)
+{
+	size_t i;
+	Entry last;
+
+	if (!contains(node))
+		return;
+
+	i = node->data.openPos;
+	node->data.openPos = -1;
+
+	// fill the hole with the last entry and restore the heap order
+	last = heap.back();
+	heap.pop_back();
+	if (i == heap.size())
+		return;
+
+	place(i, last);
+	if (i > 0 && before(heap[i], heap[(i-1)/2]))
+		siftUp(i);
+	else
+		siftDown(i);
+}
+
+/*
+	Function: update()
+	Desc.	: change the key of a node on the open list
+	Para.	: node, a node on the open list
+			  key, new key
+	Return	: None
+*/
+void OpenList::update(treeNode *node, double key)
+{
+	size_t i;
+	double oldKey;
+
+	if (!contains(node))
+		return;
+
+	i = node->data.openPos;
+	oldKey = heap[i].key;
+	heap[i].key = key;
+
+	if (key < oldKey)
+		siftUp(i);
+	else
+		siftDown(i);
+}
+
+void OpenList::insert(treeNode *node, double key, long seq)
+{
+	Entry e;
+
+	e.key = key;
+	e.seq = seq;
+	e.node = node;
+
+	heap.push_back(e);
+	place(heap.size()-1, e);
+	siftUp(heap.size()-1);
+}
+
+bool OpenList::before(const Entry& a, const Entry& b) const
+{
+	return (a.key < b.key || (a.key == b.key && a.seq < b.seq));
+}
+
+void OpenList::place(size_t i, const Entry& e)
+{
+	heap[i] = e;
+	e.node->data.openPos = (int)i;
+}
+
+void OpenList::siftUp(size_t i)
+{
+	Entry e = heap[i];
+
+	while (i > 0 && before(e, heap[(i-1)/2]))
+	{
+		place(i, heap[(i-1)/2]);
+		i = (i-1)/2;
+	}
+	place(i, e);
+}
+
+void OpenList::siftDown(size_t i)
+{
+	size_t child;
+	Entry e = heap[i];
+	const size_t N = heap.size();
+
+	while ((child = 2*i+1) < N)
+	{
+		// the smaller child
+		if (child+1 < N && before(heap[child+1], heap[child]))
+			++child;
+
+		if (!before(heap[child], e))
+			break;
+
+		place(i, heap[child]);
+		i = child;
+	}
+	place(i, e);
+}
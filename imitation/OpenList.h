@@ -0,0 +1,84 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include <vector>
+
+#include "InternalModel.h"
+#include "NodePool.h"
+#include "tree.h"
+
+using namespace std;
+
+typedef tree_node_<Node> treeNode;
+
+// A* tree, its nodes come from a NodePool
+typedef tree<Node, PoolAllocator<treeNode> > searchTree;
+
+/*
+	Open list of the A* search, an indexed binary heap on tree nodes.
+	Each node keeps its heap position in Node::openPos, so membership checks, removal and
+	decrease-key don't need to walk the list. Nodes with equal key come out in insertion order,
+	which is the order the sorted list used to give them.
+*/
+class OpenList
+{
+	struct Entry
+	{
+		double key;			// priority, smaller first
+		long seq;			// insertion sequence, breaks ties between equal keys
+		treeNode *node;
+	};
+
+	vector<Entry> heap;
+
+	// sequence for the nodes put at the front/back of the list
+	long frontSeq, backSeq;
+
+	// whether entry a is popped before entry b
+	bool before(const Entry& a, const Entry& b) const;
+
+	// put entry e at position i and record the position on its node
+	void place(size_t i, const Entry& e);
+
+	void siftUp(size_t i);
+	void siftDown(size_t i);
+
+	void insert(treeNode *node, double key, long seq);
+
+public:
+	OpenList(void);
+	~OpenList(void);
+
+	// remove all the nodes
+	void clear();
+
+	bool empty() const;
+	size_t size() const;
+
+	// whether the node is on the open list
+	bool contains(const treeNode *node) const;
+
+	// the node with the lowest key, 0 when the list is empty
+	treeNode *front() const;
+
+	// remove and return the node with the lowest key
+	treeNode *pop();
+
+	// add a node ordered by key, behind the nodes with the same key
+	void push(treeNode *node, double key);
+
+	// add a node ahead of/behind all the nodes on the list, for policy exploration
+	void pushFront(treeNode *node);
+	void pushBack(treeNode *node);
+
+	// the nodes on the list, in no particular order
+	void getNodes(vector<treeNode *>& nodes) const;
+
+	// remove a node from the list, nothing happens if it is not on it
+	void remove(treeNode *node);
+
+	// change the key of a node on the list (decrease-key)
+	void update(treeNode *node, double key);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "PredicateTable.h"
+#include "Utility.h"
+
+PredicateTable::PredicateTable(void) : size(0)
+{
+	for (int i=0; i<SLOTS; ++i)
+	{
+		keys[i].store(0);
+		bits[i] = -1;
+	}
+}
+
+// created on first use, so states can be built during static initialization
+PredicateTable& PredicateTable::table()
+{
+	static PredicateTable predicates;
+	return predicates;
+}
+
+/*
+	Function: index()
+	Desc.	: look up the bit of a ground predicate, add it when it is new
+	Para.	: r, a relation
+	Return	: index of the bit, -1 when the relation contains a wildcard or there is no free bit
+	Note	: only adding a predicate takes the lock
+*/
+int PredicateTable::index(const Relation& r)
+{
+	PredicateTable& t = table();
+	unsigned long long k, slotKey;
+	int i;
+
+	if (r.relation.isWildcard() || r.objA.isWildcard() || r.objB.isWildcard())
+		return -1;
+
+	// never 0, the relation's index is at least EMPTY
+	k = ((unsigned long long)r.relation.num() << 42) | ((unsigned long long)r.objA.num() << 21) | r.objB.num();
+
+	for (i = mixHash(k) & (SLOTS-1); (slotKey = t.keys[i].load(memory_order_acquire)) != 0; i = (i+1) & (SLOTS-1))
+		if (slotKey == k)
+			return t.bits[i];
+
+	lock_guard<mutex> guard(t.lock);
+
+	// look again, it may have been added after the search above
+	for (i = mixHash(k) & (SLOTS-1); (slotKey = t.keys[i].load(memory_order_relaxed)) != 0; i = (i+1) & (SLOTS-1))
+		if (slotKey == k)
+			return t.bits[i];
+
+	if (t.size >= MAX_PREDICATES)
+		return -1;
+
+	t.bits[i] = t.size++;
+	t.keys[i].store(k, memory_order_release);
+
+	return t.bits[i];
+}
+
+int PredicateTable::count()
+{
+	PredicateTable& t = table();
+	lock_guard<mutex> guard(t.lock);
+
+	return t.size;
+}
@@ -0,0 +1,47 @@
+#ifndef PREDICATETABLE_H
+#define PREDICATETABLE_H
+
+#include <bitset>
+#include <atomic>
+#include <mutex>
+
+#include "Relation.h"
+
+using namespace std;
+
+// maximum number of ground predicates which can be represented by a bit
+#define MAX_PREDICATES 256
+
+typedef bitset<MAX_PREDICATES> PredicateSet;
+
+/*
+	Global table of ground predicates (relations without wildcard). Each predicate gets a bit the 
+	first time it is seen, so a state can also be kept as a set of bits.
+	The table is an open addressing hash table which is never resized, lookups don't take a lock 
+	so the training threads can build states at the same time.
+*/
+class PredicateTable
+{
+	// number of slots, a power of 2 well above MAX_PREDICATES
+	static const int SLOTS = 4*MAX_PREDICATES;
+
+	// packed relation of each slot, 0 when the slot is empty, it is written after the bit
+	atomic<unsigned long long> keys[SLOTS];
+	int bits[SLOTS];
+
+	int size;
+	mutex lock;
+
+	PredicateTable(void);
+
+	static PredicateTable& table();
+
+public:
+	// bit of a relation, -1 when it contains a wildcard or the table is full
+	static int index(const Relation& r);
+
+	// number of predicates in the table
+	static int count();
+};
+
+#endif
@@ -4,11 +4,27 @@
 Random::Random(void)
 {
 	hasNextNextGaussian = false;
+	seeded = false;
+	state = 0;
 	srand((unsigned)time(0));
 }
 
 Random::~Random(void) {}
 
+/*
+	Function: seed()
+	Desc.	: start an own sequence of random numbers, rand() isn't used by this instance any more
+	Para.	: s, seed
+	Return	: None
+	Note	: the same seed always gives the same sequence, also when other threads draw random numbers
+*/
+void Random::seed(unsigned long long s)
+{
+	seeded = true;
+	state = s;
+	hasNextNextGaussian = false;
+}
+
 /*
 	Function: nextDouble()
 	Desc.	: Generate a random double value from 0 to 1
@@ -17,8 +33,19 @@ Random::~Random(void) {}
 */
 double Random::nextDouble()
 {
-	//return a random value in the range [0,1);
-	return (double)rand()/(RAND_MAX+1.0);
+	unsigned long long z;
+
+	if (!seeded)
+		//return a random value in the range [0,1);
+		return (double)rand()/(RAND_MAX+1.0);
+
+	// SplitMix64, the highest 53 bits give a value in [0,1)
+	z = (state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z ^= z >> 31;
+
+	return (z >> 11) * (1.0/9007199254740992.0);
 }
 
 /*
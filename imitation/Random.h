@@ -12,10 +12,17 @@ class Random
 private:
 	bool hasNextNextGaussian;
 	double nextNextGaussian;
+
+	// own generator state, used instead of rand() once seed() is called
+	bool seeded;
+	unsigned long long state;
 public:
 	Random(void);
 	~Random(void);
 
+	// give this instance its own sequence, independent of rand() and of the other instances
+	void seed(unsigned long long s);
+
 	// generate a random double value in [0,1)	
 	double nextDouble();
 
@@ -1,9 +1,9 @@
 #include "Relation.h"
+#include "Utility.h"
 
-Relation::Relation(string relationVal, string objAVal, string objBVal)
+Relation::Relation(Symbol relationVal, Symbol objAVal, Symbol objBVal)
 : objA(objAVal), objB(objBVal), relation(relationVal){}
 
-Relation::~Relation(void) {}
 
 /*
 	Function: == operator
@@ -13,7 +13,18 @@ Relation::~Relation(void) {}
 */
 bool Relation::operator==(const Relation& r) const
 {
-	return ((r.objA == "?" || objA==r.objA) && (r.objB == "?" || objB==r.objB) && (r.relation == "?" || relation==r.relation));
+	return ((r.objA.isWildcard() || objA==r.objA) && (r.objB.isWildcard() || objB==r.objB) && (r.relation.isWildcard() || relation==r.relation));
+}
+
+/*
+	Function: hash()
+	Desc.	: hash value of this instance, equal relations have the same hash value
+	Para.	: None
+	Return	: size_t
+*/
+size_t Relation::hash() const
+{
+	return mixHash(((unsigned long long)relation.num() << 42) ^ ((unsigned long long)objA.num() << 21) ^ objB.num());
 }
 
 /*
@@ -24,5 +35,5 @@ bool Relation::operator==(const Relation& r) const
 */
 string Relation::toString() const
 {
-	return relation + " " + objA + " " + objB + "\n";
+	return relation.str() + " " + objA.str() + " " + objB.str() + "\n";
 }
\ No newline at end of file
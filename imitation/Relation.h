@@ -2,22 +2,28 @@
 #define RELATION_H
 
 #include <string>
+#include <functional>
+
+#include "Symbol.h"
 
 using namespace std;
 class Relation
 {
 public:
 	/* attribute */ 
-	string objA;
-	string objB;
-	string relation;
+	Symbol objA;
+	Symbol objB;
+	Symbol relation;
 	
 	/* constructor */
-	Relation(string relationVal="", string objAVal="", string objBVal="");
-	~Relation(void);
+	Relation(Symbol relationVal=Symbol(), Symbol objAVal=Symbol(), Symbol objBVal=Symbol());
+	~Relation(void) = default;		// trivial, so relations can be kept in a SmallVector
 
 	/* Method */
 	bool operator==(const Relation& r) const;
+
+	// hash value of this instance
+	size_t hash() const;
 	
 	// returns a String that represents this instance.
 	string toString() const;
@@ -0,0 +1,11 @@
+#include "SearchContext.h"
+
+SearchContext::SearchContext(void) : currAStarTree(PoolAllocator<treeNode>(&currNodePool)), newAStarTree(PoolAllocator<treeNode>(&newNodePool)), 
+	currGraph(0), currTransitions(0), weight(1), bound(1), currReward(0), newReward(0)
+{
+	// the empty trees hold their head and feet, the pools keep them when they are released
+	currNodePool.mark();
+	newNodePool.mark();
+}
+
+SearchContext::~SearchContext(void) {}
@@ -0,0 +1,112 @@
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+#include <vector>
+#include <list>
+#include <mutex>
+
+#include "InternalModel.h"
+#include "OpenList.h"
+#include "NodeTable.h"
+#include "SearchGraph.h"
+#include "TransitionGraph.h"
+#include "DistanceCache.h"
+#include "FeatureEncoder.h"
+#include "FeedForward.h"
+#include "EmbeddingTable.h"
+#include "BeamLevels.h"
+#include "Random.h"
+#include "Object.h"
+#include "State.h"
+
+using namespace std;
+
+// policy & sibling type
+typedef struct pair<vector<Node>, vector<Node> > psType;
+
+/*
+	Everything a search works on: the demonstration, the imitation environment, the open list and the
+	A* trees. Each training task gets its own context, so tasks can be searched on different threads
+	while the network and the primitive actions are shared.
+*/
+class SearchContext
+{
+public:
+	// current observed model, only contain one demonstration
+	vector<Object> currObservedObjects;
+	vector<State> currObservedStates;
+
+	// objects in the internal model
+	vector<Object> intObjects;
+
+	// open list stores the nodes that have not been expanded, the nodes that have been expanded are flagged closed.
+	OpenList openList;
+
+	// the nodes in the A* tree of the current search, indexed by their internal state
+	NodeTable nodeTable;
+
+	// pools of the nodes of the A* trees, declared first so they outlive the trees
+	NodePool<treeNode> currNodePool, newNodePool;
+
+	// current A* tree, only for the current A* search
+	searchTree currAStarTree, newAStarTree;
+
+	// graph of the current search, 0 when the search doesn't keep its graph
+	SearchGraph *currGraph;
+
+	// lock of the current graph, held during the search
+	unique_lock<mutex> graphGuard;
+
+	// transitions between the states reached by the searches of this context, one graph for each set of
+	// internal objects, and the one of the current search
+	list<TransitionGraph> transitionGraphs;
+	TransitionGraph *currTransitions;
+
+	// weight of the heuristic cost in the keys of the open list, 1 for A*
+	double weight;
+
+	// suboptimality bound of the policy found by the last anytime search
+	double bound;
+
+	// the nodes of each level of the current search, only bounded by BEAM
+	BeamLevels beam;
+
+	// use for exploration
+	Random r;
+
+	// distances already given by the current network
+	DistanceCache distanceCache;
+
+	// network input of the observed and of the internal states of the current problem
+	FeatureEncoder extEncoder, intEncoder;
+
+	// the network's hidden layer for the values of the input of the current problem
+	EmbeddingTable embeddings;
+
+	// network input of the internal state whose successors are evaluated and the hidden units' input for it
+	vector<double> parentFeatures;
+	FeedForward::Activation parentActivation;
+
+	// buffers of the batched distance calculation, kept to avoid allocating them at each expansion
+	vector<const InternalState *> batchStates;
+	vector<double> batchDistances;
+	vector<double> batchInputs, batchOutputs;		// network inputs one after another and their outputs
+	vector<size_t> batchRows;						// index in batchStates of each network input
+	vector<int> batchChanges;						// with a parent, the positions where each input differs from its input
+	vector<size_t> batchChangeStarts;				// start of the positions of each input in batchChanges, and the end
+	vector<SearchGraph::Vertex *> batchVertices;
+
+	// current/new policy of the task and their reward
+	psType currPolicySibling, newPolicySibling;
+	double currReward, newReward;
+
+	SearchContext(void);
+	~SearchContext(void);
+
+private:
+	// the nodes refer to the open list/trees of their own context
+	SearchContext(const SearchContext&);
+	void operator=(const SearchContext&);
+};
+
+#endif
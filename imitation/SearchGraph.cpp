@@ -0,0 +1,83 @@
+#include "SearchGraph.h"
+
+SearchGraph::SearchGraph(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal, 
+	const vector<Action>& actions)
+: observedObjects(observedObjectsVal), observedStates(observedStatesVal), intObjects(intObjectsVal), actionTable(actions, intObjectsVal) {}
+
+SearchGraph::~SearchGraph(void) {}
+
+/*
+	Function: matches()
+	Desc.	: check whether this instance is the graph of the given problem
+	Para.	: observedObjectsVal, observedStatesVal, the observed model
+			  intObjectsVal, the internal objects
+	Return	: bool
+*/
+bool SearchGraph::matches(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal) const
+{
+	if (observedStates.size() != observedStatesVal.size() || !sameObjects(intObjects, intObjectsVal) || !sameObjects(observedObjects, observedObjectsVal))
+		return false;
+
+	for (size_t i=0; i<observedStates.size(); ++i)
+		if (observedStates[i] != observedStatesVal[i])
+			return false;
+
+	return true;
+}
+
+/*
+	Function: vertex()
+	Desc.	: look for the vertex of a state, add it when it is new
+	Para.	: s, an internal state
+	Return	: the vertex
+	Note	: the order of the relations and the objects next to each other are part of the identity, 
+			  they decide the successors
+*/
+SearchGraph::Vertex& SearchGraph::vertex(const InternalState& s)
+{
+	const size_t key = s.state->hash() ^ mixHash(s.extStateNum);
+	pair<unordered_multimap<size_t, Vertex *>::iterator, unordered_multimap<size_t, Vertex *>::iterator> range;
+	Vertex v;
+
+	range = index.equal_range(key);
+	for (; range.first != range.second; ++range.first)
+	{
+		Vertex& u = *range.first->second;
+		if (u.state.extStateNum == s.extStateNum && u.state.state.identical(s.state))
+			return u;
+	}
+
+	v.state = s;
+	v.expanded = false;
+	v.mean = 0;
+	v.version = -1;
+
+	vertices.push_back(v);
+	index.insert(make_pair(key, &vertices.back()));
+
+	return vertices.back();
+}
+
+/*
+	Function: successors()
+	Desc.	: successors of a state, they are generated the first time and kept for later searches
+	Para.	: s, an internal state
+	Return	: the successors, in the order InternalState::genSuccessors gives them
+*/
+const list<InternalState>& SearchGraph::successors(const InternalState& s)
+{
+	Vertex& v = vertex(s);
+
+	if (!v.expanded)
+	{
+		v.successors = v.state.genSuccessors(actionTable);
+		v.expanded = true;
+	}
+
+	return v.successors;
+}
+
+size_t SearchGraph::size() const
+{
+	return vertices.size();
+}
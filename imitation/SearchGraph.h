@@ -0,0 +1,76 @@
+#ifndef SEARCHGRAPH_H
+#define SEARCHGRAPH_H
+
+#include <deque>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "InternalState.h"
+#include "Object.h"
+#include "Action.h"
+#include "ActionTable.h"
+
+using namespace std;
+
+/*
+	The part of the state graph explored by the searches of one problem (an observed model and
+	the internal objects it is imitated with). The graph doesn't change between training rounds,
+	only the distances given by the network do, so each vertex keeps its successors, its network
+	input and the last network output with the version of the weights it was computed with.
+	A search of the same problem then only has to evaluate the network again for the vertices it
+	reaches after the weights changed.
+*/
+class SearchGraph
+{
+public:
+	struct Vertex
+	{
+		InternalState state;
+		bool expanded;
+		list<InternalState> successors;		// valid when expanded
+
+		vector<double> input;				// network input, empty until it is needed
+		double mean;						// network output
+		long version;						// version of the weights mean was computed with, -1 when none
+	};
+
+private:
+	// the problem
+	vector<Object> observedObjects;
+	vector<State> observedStates;
+	vector<Object> intObjects;
+
+	// the actions grounded with the internal objects
+	ActionTable actionTable;
+
+	deque<Vertex> vertices;				// deque keeps the references valid when it grows
+	unordered_multimap<size_t, Vertex *> index;
+
+	// the index points into vertices, copies would point into the original
+	SearchGraph(const SearchGraph&);
+	void operator=(const SearchGraph&);
+
+public:
+	SearchGraph(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal, 
+		const vector<Action>& actions);
+	~SearchGraph(void);
+
+	// held by the search using this instance
+	mutex lock;
+
+	// check whether this instance is the graph of the given problem
+	bool matches(const vector<Object>& observedObjectsVal, const vector<State>& observedStatesVal, const vector<Object>& intObjectsVal) const;
+
+	// the vertex of a state, added when it is new
+	Vertex& vertex(const InternalState& s);
+
+	// successors of a state, generated the first time
+	const list<InternalState>& successors(const InternalState& s);
+
+	// number of vertices
+	size_t size() const;
+};
+
+#endif
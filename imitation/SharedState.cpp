@@ -0,0 +1,41 @@
+#include "SharedState.h"
+
+// the state of the empty instances, created on first use so that default construction doesn't allocate
+static const shared_ptr<State>& emptyState()
+{
+	static const shared_ptr<State> empty = make_shared<State>();
+	return empty;
+}
+
+SharedState::SharedState(void) : ptr(emptyState()) {}
+SharedState::SharedState(const State& s) : ptr(make_shared<State>(s)) {}
+SharedState::SharedState(State&& s) : ptr(make_shared<State>(move(s))) {}
+
+/*
+	Function: edit()
+	Desc.	: the state to be changed, the other instances sharing it keep the old one
+	Para.	: None
+	Return	: the state of this instance only
+*/
+State& SharedState::edit()
+{
+	if (ptr.use_count() != 1)
+		ptr = make_shared<State>(*ptr);
+
+	return *ptr;
+}
+
+bool SharedState::operator==(const SharedState& s) const
+{
+	return ptr == s.ptr || *ptr == *s.ptr;
+}
+
+bool SharedState::operator!=(const SharedState& s) const
+{
+	return !(*this == s);
+}
+
+bool SharedState::identical(const SharedState& s) const
+{
+	return ptr == s.ptr || ptr->identical(*s.ptr);
+}
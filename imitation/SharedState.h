@@ -0,0 +1,43 @@
+#ifndef SHAREDSTATE_H
+#define SHAREDSTATE_H
+
+#include <memory>
+
+#include "State.h"
+
+using namespace std;
+
+/*
+	A state shared by the internal states and the nodes which hold the same relations.
+	The two successors of an action (for the current and the next observed state) share the state
+	the action gives, the successor without action shares the state of its parent, and the successors
+	replayed from a TransitionGraph or a SearchGraph share the state kept by the graph, so copying an
+	InternalState or a Node only copies a pointer. A shared state is never changed, edit() makes a
+	copy first when the state is shared.
+*/
+class SharedState
+{
+	shared_ptr<State> ptr;			// never 0, an empty state is shared by all the empty instances
+
+public:
+	SharedState(void);
+	SharedState(const State& s);
+	SharedState(State&& s);
+
+	const State& operator*() const { return *ptr; }
+	const State *operator->() const { return ptr.get(); }
+	operator const State&() const { return *ptr; }
+
+	// the state to be changed, copied first when it is shared
+	State& edit();
+
+	// check whether the given instance shares the state of this instance
+	bool shares(const SharedState& s) const { return ptr == s.ptr; }
+
+	// compare the states, shared states are equal without comparing the relations
+	bool operator==(const SharedState& s) const;
+	bool operator!=(const SharedState& s) const;
+	bool identical(const SharedState& s) const;
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+using namespace std;
+
+/*
+	A vector of trivially copyable values which keeps up to N of them inside the object and only goes
+	to the heap when it grows past N. The values are moved around with memcpy and the object doesn't
+	point into itself, so copying a State or a Node with few relations doesn't allocate and the
+	values are next to the rest of the object.
+	Only the part of the vector interface used by State is provided.
+*/
+template <class T, size_t N>
+class SmallVector
+{
+	static_assert(is_trivially_copyable<T>::value, "SmallVector only keeps trivially copyable values");
+
+	size_t count;
+	size_t capacity;			// N while the values are inline
+	T *heap;					// 0 while the values are inline
+	alignas(T) unsigned char buffer[N * sizeof(T)];
+
+	T *data() { return heap != 0 ? heap : reinterpret_cast<T *>(buffer); }
+	const T *data() const { return heap != 0 ? heap : reinterpret_cast<const T *>(buffer); }
+
+	/*
+		Function: grow()
+		Desc.	: make room for at least n values, they move to the heap
+		Para.	: n, number of values
+		Return	: None
+	*/
+	void grow(size_t n)
+	{
+		if (n <= capacity)
+			return;
+
+		if (n < 2*capacity)
+			n = 2*capacity;
+
+		T *p = static_cast<T *>(::operator new(n * sizeof(T)));
+		memcpy(static_cast<void *>(p), static_cast<const void *>(data()), count * sizeof(T));
+
+		if (heap != 0)
+			::operator delete(heap);
+
+		heap = p;
+		capacity = n;
+	}
+
+public:
+	typedef T value_type;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+
+	SmallVector(void) : count(0), capacity(N), heap(0) {}
+
+	SmallVector(const SmallVector& v) : count(0), capacity(N), heap(0)
+	{
+		grow(v.count);
+		memcpy(static_cast<void *>(data()), static_cast<const void *>(v.data()), v.count * sizeof(T));
+		count = v.count;
+	}
+
+	// a heap buffer is taken over, inline values are copied
+	SmallVector(SmallVector&& v) noexcept : count(v.count), capacity(v.capacity), heap(v.heap)
+	{
+		if (heap == 0)
+			memcpy(buffer, v.buffer, count * sizeof(T));
+
+		v.count = 0;
+		v.capacity = N;
+		v.heap = 0;
+	}
+
+	~SmallVector(void)
+	{
+		if (heap != 0)
+			::operator delete(heap);
+	}
+
+	SmallVector& operator=(const SmallVector& v)
+	{
+		if (this != &v)
+		{
+			count = 0;
+			grow(v.count);
+			memcpy(static_cast<void *>(data()), static_cast<const void *>(v.data()), v.count * sizeof(T));
+			count = v.count;
+		}
+		return *this;
+	}
+
+	SmallVector& operator=(SmallVector&& v) noexcept
+	{
+		if (this != &v)
+		{
+			if (heap != 0)
+				::operator delete(heap);
+
+			count = v.count;
+			capacity = v.capacity;
+			heap = v.heap;
+			if (heap == 0)
+				memcpy(buffer, v.buffer, count * sizeof(T));
+
+			v.count = 0;
+			v.capacity = N;
+			v.heap = 0;
+		}
+		return *this;
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	iterator begin() { return data(); }
+	iterator end() { return data() + count; }
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + count; }
+
+	T& operator[](size_t i) { return data()[i]; }
+	const T& operator[](size_t i) const { return data()[i]; }
+
+	void reserve(size_t n) { grow(n); }
+
+	void clear() { count = 0; }
+
+	void push_back(const T& x)
+	{
+		if (count == capacity)
+		{
+			T copy = x;			// x may be one of the values
+			grow(count+1);
+			data()[count++] = copy;
+		}
+		else
+			data()[count++] = x;
+	}
+
+	// insert the values [first, last) before pos, they mustn't be values of this instance
+	iterator insert(iterator pos, const T *first, const T *last)
+	{
+		const size_t i = pos - data(), n = last - first;
+
+		grow(count + n);
+		memmove(static_cast<void *>(data() + i + n), static_cast<const void *>(data() + i), (count - i) * sizeof(T));
+		memcpy(static_cast<void *>(data() + i), static_cast<const void *>(first), n * sizeof(T));
+		count += n;
+
+		return data() + i;
+	}
+
+	iterator erase(iterator pos)
+	{
+		memmove(static_cast<void *>(pos), static_cast<const void *>(pos + 1), (end() - pos - 1) * sizeof(T));
+		--count;
+		return pos;
+	}
+
+	bool operator==(const SmallVector& v) const
+	{
+		if (count != v.count)
+			return false;
+
+		for (size_t i=0; i<count; ++i)
+			if (!(data()[i] == v.data()[i]))
+				return false;
+
+		return true;
+	}
+
+	bool operator!=(const SmallVector& v) const { return !(*this == v); }
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "State.h"
 
-State::State(void) {}
+State::State(void) : key(0), loose(0) {}
 State::~State(void) {}
 
 /*
@@ -9,12 +9,16 @@ State::~State(void) {}
 	Para.	: s, the state that are going to be compared
 	Return	: return true if each element in state s can be found in this instance
 	Note	: These two states can be equal.
-			  This method can be used to check whether one action's precondition is satisifed in current state
+			  This method can be used to check whether one action's precondition is satisifed in current state.
+			  When both states are kept as bits, it is a mask test.
 */
-bool State::operator>=(State s)
+bool State::operator>=(const State& s) const
 {
 	int i;
-	vector<Relation>::const_iterator p;
+	const_iterator p;
+
+	if (loose==0 && s.loose==0)
+		return (s.bits & ~bits).none();
 
 	// check each element in state s
 	for (i=0; i<s.size(); ++i)
@@ -32,11 +36,16 @@ bool State::operator>=(State s)
 	Desc.	: compares this instance with a specified state
 	Para.	: s, the state that are going to be compared
 	Return	: return true if equal, otherwise return false
+	Note	: the cached hash values are compared first, so unequal states are rejected in constant time.
+			  Relations with wildcard "?" are not supported, use >= for patterns.
 */
-bool State::operator==(State s)
+bool State::operator==(const State& s) const
 {
-	if (state.size()!=s.size()) 
+	if (state.size()!=s.size() || key!=s.key) 
 		return false;
+
+	if (loose==0 && s.loose==0)
+		return (bits == s.bits);
 	
 	return (*this >= s);
 }
@@ -47,11 +56,24 @@ bool State::operator==(State s)
 	Para.	: s, the state that are going to be compared
 	Return	: return true if not equal, otherwise return false
 */
-bool State::operator!=(State s)
+bool State::operator!=(const State& s) const
 {
 	return !(*this==s);
 }
 
+/*
+	Function: hash()
+	Desc.	: hash value of this instance
+	Para.	: None
+	Return	: size_t
+	Note	: the relations' hash values are added up, so the same relations in any order give the same value.
+			  The value is cached and updated whenever a relation is added, removed or replaced.
+*/
+size_t State::hash() const
+{
+	return key;
+}
+
 /*
 	Function: size()
 	Desc.	: return the size of this instance
@@ -70,10 +92,13 @@ int State::size() const
 	Return	: None
 	Note	: This method is used to remove precondition from current state after execute an action
 */
-void State::remove(State removed) 
+void State::remove(const State& removed) 
 {
 	int i;
-	vector<Relation>::iterator p;
+	Relation *p;
+
+	// when all the removed relations are in this instance, their bits can be cleared at once
+	const bool masked = (loose==0 && removed.loose==0 && (removed.bits & ~bits).none());
 
 	for (i=0; i<removed.size(); ++i)
 	{
@@ -82,8 +107,16 @@ void State::remove(State removed)
 		
 		// remove from this instance
 		if (p!=state.end())
+		{
+			key -= p->hash();
 			state.erase(p);
+		}
 	}
+
+	if (masked)
+		bits &= ~removed.bits;
+	else
+		rebuildBits();
 }
 
 /*
@@ -93,9 +126,16 @@ void State::remove(State removed)
 	Return	: None
 	Note	: This method is used to add postcondition to current state after execute an action
 */
-void State::add(State added) 
+void State::add(const State& added) 
 {
 	state.insert(state.end(), added.begin(), added.end());
+	key += added.key;
+
+	if (added.loose==0 && (bits & added.bits).none())
+		bits |= added.bits;
+	else
+		for (int i=0; i<added.size(); ++i)
+			addBit(added[i]);
 }
 
 /*
@@ -104,9 +144,41 @@ void State::add(State added)
 	Para.	: added, the relation that are going to be added.
 	Return	: None
 */
-void State::add(Relation added) 
+void State::add(const Relation& added) 
 {
 	state.push_back(added);
+	key += added.hash();
+	addBit(added);
+}
+
+/*
+	Function: addBit()
+	Desc.	: set the bit of one relation, count it as loose when it has no bit of its own
+	Para.	: r, a relation of this instance
+	Return	: None
+*/
+void State::addBit(const Relation& r)
+{
+	int i = PredicateTable::index(r);
+
+	if (i<0 || bits.test(i))
+		++loose;
+	else
+		bits.set(i);
+}
+
+/*
+	Function: rebuildBits()
+	Desc.	: recompute the bits from the relations
+	Para.	: None
+	Return	: None
+*/
+void State::rebuildBits()
+{
+	bits.reset();
+	loose = 0;
+	for (size_t i=0; i<state.size(); ++i)
+		addBit(state[i]);
 }
 
 /*
@@ -115,11 +187,35 @@ void State::add(Relation added)
 	Para.	: i, subscript
 	Return	: Relation, one relation in this instance specified by the subscript
 */
-Relation &State::operator[](int i)
+const Relation &State::operator[](int i) const
 {
 	return state[i];
 }
 
+/*
+	Function: replace()
+	Desc.	: replace one relation in this instance, its position doesn't change
+	Para.	: i, subscript
+			  r, the new relation
+	Return	: None
+*/
+void State::replace(int i, const Relation& r)
+{
+	key += r.hash() - state[i].hash();
+
+	if (loose==0)
+	{
+		bits.reset(PredicateTable::index(state[i]));
+		state[i] = r;
+		addBit(r);
+	}
+	else
+	{
+		state[i] = r;
+		rebuildBits();
+	}
+}
+
 /*
 	Function: clear()
 	Desc.	: Clear this instance
@@ -129,6 +225,9 @@ Relation &State::operator[](int i)
 void State::clear()
 {
 	state.clear();
+	key = 0;
+	bits.reset();
+	loose = 0;
 }
 
 /*
@@ -139,7 +238,7 @@ void State::clear()
 	Return	: if there is a match, return its position; otherwise return -1
 	Note	: the main purpose of this function is check whether a relation exists in a pattern
 */
-vector<Relation>::const_iterator State::findPattern(const Relation& pattern) const
+State::const_iterator State::findPattern(const Relation& pattern) const
 {	
 	return find(state.begin(), state.end(), pattern);
 }
@@ -164,18 +263,14 @@ string State::toString() const
 
 string State::nextToObjects() const
 {
-	string s = "";
-	for (size_t i=0; i<nextTo.size(); ++i)
-		s += nextTo[i] + " ";
-
-	return s;
+	return nextTo.toString();
 }
-vector<Relation>::iterator State::begin()
+State::const_iterator State::begin() const
 {
 	return state.begin();
 }
 
-vector<Relation>::iterator State::end()
+State::const_iterator State::end() const
 {
 	return state.end();
 }
@@ -192,10 +287,23 @@ void State::updateNextTo()
 	
 	nextTo.clear();
 	for (i=0; i<state.size(); ++i)
-		if (state[i].relation == "NEXT")
-			nextTo.push_back(state[i].objB);
+		if (state[i].relation == SYM_NEXT)
+			nextTo.add(state[i].objB);
 	
 	// if only next to one object, ignore
 	if (nextTo.size()<2)
 		nextTo.clear();
-}
\ No newline at end of file
+}
+
+/*
+	Function: identical()
+	Desc.	: check whether the given state is a copy of this instance
+	Para.	: s, the state that are going to be compared
+	Return	: true when the relations are the same and in the same order, and the nextTo objects are the same
+	Note	: equal states (==) can list their relations in different order, which changes the order of 
+			  the relations in their successors
+*/
+bool State::identical(const State& s) const
+{
+	return (key == s.key && state == s.state && nextTo == s.nextTo);
+}
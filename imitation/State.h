@@ -6,47 +6,84 @@
 #include <algorithm>
 
 #include "Relation.h"
+#include "PredicateTable.h"
+#include "SmallVector.h"
+#include "ObjectSet.h"
 #include "Utility.h"
 
 using namespace std;
 
+// number of relations kept inside a state, more go to the heap
+#define STATE_CAPACITY 10
+
 class Action;
 
 class State
 {
 private:
-	vector<Relation> state;
+	SmallVector<Relation, STATE_CAPACITY> state;
+
+	// order-independent hash of the relations, kept up to date by add/remove/replace
+	size_t key;
+
+	// the relations as bits of the predicate table, kept up to date together with key
+	PredicateSet bits;
+
+	// number of relations which are not in bits (wildcard, duplicate, or no free bit)
+	// the bits are only used for comparison when it is 0
+	int loose;
+
+	// set the bit of one relation
+	void addBit(const Relation& r);
+
+	// recompute the bits from the relations
+	void rebuildBits();
 
 protected:
-	vector<string> nextTo;
+	ObjectSet nextTo;
 	friend class Action;
+	friend class EffectCheck;	// check.cpp
 
 public:
+	typedef const Relation *const_iterator;
+
 	State(void);
 	~State(void);
 
+	// the destructor is declared, so the copies and moves have to be asked for
+	State(const State& s) = default;
+	State(State&& s) = default;
+	State& operator=(const State& s) = default;
+	State& operator=(State&& s) = default;
+
 	// add a relation to this instance
-	void add(Relation added);
+	void add(const Relation& added);
 
 	// add all the relations in the specified state to this instance
-	void add(State added);
+	void add(const State& added);
 
 	// clear this instance
 	void clear();
 
 	// check whether a relation exists in a relation container
-	vector<Relation>::const_iterator findPattern(const Relation& pattern) const;
+	const_iterator findPattern(const Relation& pattern) const;
 
 	// compares this instance with a specified state
-	bool operator==(State s);
-	bool operator!=(State s);
-	bool operator>=(State s);
+	bool operator==(const State& s) const;
+	bool operator!=(const State& s) const;
+	bool operator>=(const State& s) const;
+
+	// hash value which doesn't depend on the order of the relations
+	size_t hash() const;
 
 	// overload the [] subscript
-	Relation &operator[](int i);
+	const Relation &operator[](int i) const;
+
+	// replace the i-th relation
+	void replace(int i, const Relation& r);
 
 	// remove all the relations of the specified state from this instance
-	void remove(State removed);
+	void remove(const State& removed);
 
 	//// return the size of the state
 	int size() const;
@@ -55,11 +92,14 @@ public:
 	string toString() const;
 	string nextToObjects() const;
 
-	vector<Relation>::iterator begin();
-	vector<Relation>::iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
 
 	// update nextTo relation between objects
 	void updateNextTo();
+
+	// check whether the given state has the same relations, in the same order, and the same nextTo objects
+	bool identical(const State& s) const;
 };
 
 #endif
@@ -0,0 +1,66 @@
+#include "StateLayer.h"
+#include "Utility.h"
+
+StateLayer::StateLayer(void) {}
+
+StateLayer::~StateLayer(void) {}
+
+size_t StateLayer::key(const InternalState& s)
+{
+	return s.state->hash() ^ mixHash(s.extStateNum);
+}
+
+/*
+	Function: relax()
+	Desc.	: record a path to a state when it is cheaper than the known one
+	Para.	: s, the state
+			  g, cost of the path
+			  parentLayer, parent, the previous state on the path
+	Return	: index of the state when the path is recorded, -1 when the known path isn't more expensive
+*/
+int StateLayer::relax(const InternalState& s, double g, int parentLayer, int parent)
+{
+	pair<unordered_multimap<size_t, int>::iterator, unordered_multimap<size_t, int>::iterator> range;
+	Entry e;
+	const size_t k = key(s);
+
+	range = index.equal_range(k);
+	for (; range.first != range.second; ++range.first)
+	{
+		Entry& old = entries[range.first->second];
+		if (old.state.extStateNum == s.extStateNum && old.state.state == s.state)
+		{
+			if (g >= old.g)
+				return -1;
+
+			old.state = s;
+			old.g = g;
+			old.parentLayer = parentLayer;
+			old.parent = parent;
+			old.expanded = false;
+			return range.first->second;
+		}
+	}
+
+	e.state = s;
+	e.g = g;
+	e.parentLayer = parentLayer;
+	e.parent = parent;
+	e.expanded = false;
+
+	entries.push_back(e);
+	index.insert(make_pair(k, (int)entries.size()-1));
+
+	return (int)entries.size()-1;
+}
+
+size_t StateLayer::size() const
+{
+	return entries.size();
+}
+
+void StateLayer::clear()
+{
+	entries.clear();
+	index.clear();
+}
@@ -0,0 +1,47 @@
+#ifndef STATELAYER_H
+#define STATELAYER_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "InternalState.h"
+
+using namespace std;
+
+/*
+	The internal states of one observed state (one extStateNum) reached by the layered search, with the
+	cost of the cheapest path to each of them and where that path comes from. States are looked up by 
+	their hash, so a state reached again is found without scanning the layer.
+*/
+class StateLayer
+{
+public:
+	struct Entry
+	{
+		InternalState state;
+		double g;
+		int parentLayer, parent;	// the previous state on the cheapest path, -1 for the start state
+		bool expanded;
+	};
+
+private:
+	vector<Entry> entries;
+	unordered_multimap<size_t, int> index;
+
+	static size_t key(const InternalState& s);
+
+public:
+	StateLayer(void);
+	~StateLayer(void);
+
+	// lower the cost of a state, add it when it is new, return its index when the cost is lowered, -1 otherwise
+	int relax(const InternalState& s, double g, int parentLayer, int parent);
+
+	Entry& operator[](int i) { return entries[i]; }
+	const Entry& operator[](int i) const { return entries[i]; }
+
+	size_t size() const;
+	void clear();
+};
+
+#endif
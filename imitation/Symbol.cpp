@@ -0,0 +1,89 @@
+#include "Symbol.h"
+
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+// the strings and their indexes, "?" and "" are added first to get the reserved indexes WILDCARD and EMPTY
+struct SymbolTable
+{
+	deque<string> names;		// deque keeps references valid when it grows
+	unordered_map<string, int> ids;
+	mutex lock;					// symbols are created and printed by the training threads
+
+	SymbolTable(void)
+	{
+		add("?");
+		add("");
+	}
+
+	int add(const string& s)
+	{
+		ids.insert(make_pair(s, (int)names.size()));
+		names.push_back(s);
+		return (int)names.size()-1;
+	}
+};
+
+// created on first use, so symbols can be constructed during static initialization
+static SymbolTable& symbolTable()
+{
+	static SymbolTable table;
+	return table;
+}
+
+const Symbol SYM_WILDCARD("?"), SYM_ON("ON"), SYM_NEXT("NEXT"), SYM_AWAY("AWAY"), SYM_IMITATOR("Imitator"), SYM_GRIPPER("Gripper"), 
+	SYM_NULL("NULL"), SYM_TRASHCAN("Trashcan"), SYM_PARA_1("PARA_1"), SYM_PARA_2("PARA_2"), SYM_DEMO("Demo");
+
+Symbol::Symbol(void) : id(EMPTY) {}
+Symbol::Symbol(const string& s) : id(intern(s)) {}
+Symbol::Symbol(const char* s) : id(intern(s)) {}
+
+/*
+	Function: intern()
+	Desc.	: look up a string in the symbol table, add it when it is new
+	Para.	: s, string
+	Return	: index of the string
+*/
+int Symbol::intern(const string& s)
+{
+	SymbolTable& table = symbolTable();
+	lock_guard<mutex> guard(table.lock);
+	unordered_map<string, int>::const_iterator p = table.ids.find(s);
+
+	if (p != table.ids.end())
+		return p->second;
+
+	return table.add(s);
+}
+
+const string& Symbol::str() const
+{
+	SymbolTable& table = symbolTable();
+	lock_guard<mutex> guard(table.lock);
+
+	return table.names[id];
+}
+
+int Symbol::count()
+{
+	SymbolTable& table = symbolTable();
+	lock_guard<mutex> guard(table.lock);
+
+	return (int)table.names.size();
+}
+
+ostream& operator<<(ostream& out, const Symbol& s)
+{
+	return out << s.str();
+}
+
+string operator+(const string& s, const Symbol& sym)
+{
+	return s + sym.str();
+}
+
+string operator+(const Symbol& sym, const string& s)
+{
+	return sym.str() + s;
+}
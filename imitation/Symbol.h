@@ -0,0 +1,61 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <string>
+#include <ostream>
+
+using namespace std;
+
+/*
+	An interned token (relation, object name, color, texture...).
+	Every distinct string is stored once in a global table and a Symbol only keeps its index,
+	so comparing and copying symbols doesn't touch the strings. The string form is only needed
+	for printing.
+*/
+class Symbol
+{
+	int id;
+
+	// return the index of the string in the symbol table, add it when it isn't there
+	static int intern(const string& s);
+
+public:
+	// reserved index of the wildcard "?", which matches any symbol in a pattern
+	static const int WILDCARD = 0;
+
+	// reserved index of the empty string
+	static const int EMPTY = 1;
+
+	Symbol(void);				// empty string
+	Symbol(const string& s);
+	Symbol(const char* s);
+
+	// index in the symbol table
+	int num() const { return id; }
+
+	// the symbol of an index in the symbol table
+	static Symbol at(int num) { Symbol s; s.id = num; return s; }
+
+	// string form of this instance
+	const string& str() const;
+
+	bool isWildcard() const { return id == WILDCARD; }
+
+	bool operator==(const Symbol& s) const { return id == s.id; }
+	bool operator!=(const Symbol& s) const { return id != s.id; }
+
+	// order of the indexes, not alphabetic order
+	bool operator<(const Symbol& s) const { return id < s.id; }
+
+	// number of symbols in the table
+	static int count();
+};
+
+// symbols referred to in the code
+extern const Symbol SYM_WILDCARD, SYM_ON, SYM_NEXT, SYM_AWAY, SYM_IMITATOR, SYM_GRIPPER, SYM_NULL, SYM_TRASHCAN, SYM_PARA_1, SYM_PARA_2, SYM_DEMO;
+
+ostream& operator<<(ostream& out, const Symbol& s);
+string operator+(const string& s, const Symbol& sym);
+string operator+(const Symbol& sym, const string& s);
+
+#endif
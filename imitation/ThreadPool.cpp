@@ -0,0 +1,126 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(void) : numOfTasks(0), nextTask(0), numOfFinished(0), batch(0), stop(false) {}
+
+ThreadPool::~ThreadPool(void)
+{
+	join();
+}
+
+/*
+	Function: join()
+	Desc.	: stop the worker threads and wait for them
+	Para.	: None
+	Return	: None
+*/
+void ThreadPool::join()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		stop = true;
+	}
+	wake.notify_all();
+
+	for (size_t i=0; i<workers.size(); ++i)
+		workers[i].join();
+
+	workers.clear();
+	stop = false;
+}
+
+/*
+	Function: resize()
+	Desc.	: set the number of threads
+	Para.	: numOfThreads, number of threads including the calling thread, at least 1
+	Return	: None
+*/
+void ThreadPool::resize(int numOfThreads)
+{
+	join();
+
+	for (int i=1; i<numOfThreads; ++i)
+		workers.push_back(thread(&ThreadPool::work, this));
+}
+
+int ThreadPool::size() const
+{
+	return (int)workers.size() + 1;
+}
+
+/*
+	Function: run()
+	Desc.	: run a batch of tasks on the threads of this instance
+	Para.	: numOfTasksVal, number of tasks
+			  taskVal, the task, called with the task number
+	Return	: None
+	Note	: the tasks are started in order, but may finish in any order
+*/
+void ThreadPool::run(int numOfTasksVal, const function<void(int)>& taskVal)
+{
+	unique_lock<mutex> guard(lock);
+
+	task = taskVal;
+	numOfTasks = numOfTasksVal;
+	nextTask = 0;
+	numOfFinished = 0;
+	++batch;
+	wake.notify_all();
+
+	while (runNext(guard))
+		;
+
+	while (numOfFinished < numOfTasks)
+		finished.wait(guard);
+
+	task = function<void(int)>();
+}
+
+/*
+	Function: runNext()
+	Desc.	: take the next task of the current batch and run it
+	Para.	: guard, the lock of this instance, held when called, released while the task runs
+	Return	: false when all the tasks of the batch have been taken
+*/
+bool ThreadPool::runNext(unique_lock<mutex>& guard)
+{
+	int i;
+
+	if (nextTask >= numOfTasks)
+		return false;
+
+	i = nextTask++;
+
+	guard.unlock();
+	task(i);
+	guard.lock();
+
+	if (++numOfFinished == numOfTasks)
+		finished.notify_all();
+
+	return true;
+}
+
+/*
+	Function: work()
+	Desc.	: loop of a worker thread, wait for a batch and help to run it
+	Para.	: None
+	Return	: None
+*/
+void ThreadPool::work()
+{
+	long done = 0;
+	unique_lock<mutex> guard(lock);
+
+	while (true)
+	{
+		while (!stop && batch == done)
+			wake.wait(guard);
+
+		if (stop)
+			return;
+
+		done = batch;
+		while (runNext(guard))
+			;
+	}
+}
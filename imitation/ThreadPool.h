@@ -0,0 +1,58 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+/*
+	A fixed set of threads which run a batch of independent tasks, run() hands out the task numbers
+	and returns when all of them are finished. The calling thread works on the tasks too, so a pool
+	of one thread runs them in order on the caller.
+*/
+class ThreadPool
+{
+	vector<thread> workers;
+
+	mutex lock;
+	condition_variable wake, finished;
+
+	// the current batch
+	function<void(int)> task;
+	int numOfTasks, nextTask, numOfFinished;
+
+	// increased for each batch, so the workers can tell a new batch from a spurious wake up
+	long batch;
+
+	bool stop;
+
+	// loop of a worker thread
+	void work();
+
+	// take the next task of the current batch and run it, false when there is none left
+	bool runNext(unique_lock<mutex>& guard);
+
+	void join();
+
+	ThreadPool(const ThreadPool&);
+	void operator=(const ThreadPool&);
+
+public:
+	ThreadPool(void);
+	~ThreadPool(void);
+
+	// set the number of threads, including the calling thread
+	void resize(int numOfThreads);
+
+	// number of threads, including the calling thread
+	int size() const;
+
+	// call task(i) for each i in [0, numOfTasksVal), return when all of them are finished
+	void run(int numOfTasksVal, const function<void(int)>& taskVal);
+};
+
+#endif
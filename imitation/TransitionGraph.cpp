@@ -0,0 +1,107 @@
+#include "TransitionGraph.h"
+
+TransitionGraph::TransitionGraph(const vector<Object>& intObjectsVal, const vector<Action>& actions) 
+: intObjects(intObjectsVal), actionTable(actions, intObjectsVal) {}
+
+TransitionGraph::~TransitionGraph(void) {}
+
+/*
+	Function: matches()
+	Desc.	: check whether this instance is the graph of the given internal objects
+	Para.	: intObjectsVal, the internal objects
+	Return	: bool
+*/
+bool TransitionGraph::matches(const vector<Object>& intObjectsVal) const
+{
+	return sameObjects(intObjects, intObjectsVal);
+}
+
+/*
+	Function: id()
+	Desc.	: look for the id of a state, add it when it is new
+	Para.	: s, a state, a new vertex shares it
+	Return	: the id
+	Note	: the order of the relations and the objects next to each other are part of the identity, 
+			  they decide the successors
+*/
+int TransitionGraph::id(const SharedState& s)
+{
+	const size_t key = s->hash();
+	pair<unordered_multimap<size_t, int>::iterator, unordered_multimap<size_t, int>::iterator> range;
+	Vertex v;
+
+	range = index.equal_range(key);
+	for (; range.first != range.second; ++range.first)
+		if (vertices[range.first->second].state.identical(s))
+			return range.first->second;
+
+	v.state = s;
+	v.expanded = false;
+
+	vertices.push_back(v);
+	index.insert(make_pair(key, (int)vertices.size()-1));
+
+	return (int)vertices.size()-1;
+}
+
+const State& TransitionGraph::state(int id) const
+{
+	return *vertices[id].state;
+}
+
+/*
+	Function: edges()
+	Desc.	: the edges of a state, they are generated the first time
+	Para.	: id, id of the state
+	Return	: the edges
+	Note	: InternalState::genSuccessors gives two successors for each action, one for the current and 
+			  one for the next observed state, and the state itself for the next observed state last
+*/
+const vector<TransitionGraph::Edge>& TransitionGraph::edges(int id)
+{
+	list<InternalState> successors;
+	list<InternalState>::iterator p;
+	Edge e;
+
+	if (!vertices[id].expanded)
+	{
+		successors = InternalState(-1, vertices[id].state, 0).genSuccessors(actionTable);
+		successors.pop_back();
+
+		for (p = successors.begin(); p != successors.end(); ++p)
+		{
+			e.action = p->action;
+			e.next = this->id(p->state);
+			vertices[id].edges.push_back(e);
+			++p;
+		}
+		vertices[id].expanded = true;
+	}
+
+	return vertices[id].edges;
+}
+
+/*
+	Function: successors()
+	Desc.	: successors of an internal state, from the edges of its state
+	Para.	: s, an internal state
+			  successors, output, replaced by the successors in the order InternalState::genSuccessors gives them
+	Return	: None
+*/
+void TransitionGraph::successors(const InternalState& s, list<InternalState>& successors)
+{
+	const vector<Edge>& e = edges(id(s.state));
+
+	successors.clear();
+	for (size_t i=0; i<e.size(); ++i)
+	{
+		successors.push_back(InternalState(e[i].action, vertices[e[i].next].state, s.extStateNum));
+		successors.push_back(InternalState(e[i].action, vertices[e[i].next].state, s.extStateNum+1));
+	}
+	successors.push_back(InternalState(-1, s.state, s.extStateNum+1));
+}
+
+size_t TransitionGraph::size() const
+{
+	return vertices.size();
+}
@@ -0,0 +1,74 @@
+#ifndef TRANSITIONGRAPH_H
+#define TRANSITIONGRAPH_H
+
+#include <deque>
+#include <list>
+#include <vector>
+#include <unordered_map>
+
+#include "InternalState.h"
+#include "Object.h"
+#include "Action.h"
+#include "ActionTable.h"
+
+using namespace std;
+
+/*
+	The grounded transitions between the internal states reachable with one set of internal objects.
+	The successors of a state only depend on the state, the primitive actions and the internal objects,
+	not on the observed model or the network, so each state is given an id the first time it is reached
+	and keeps the ids of the actions taken from it and of the states they lead to. Later searches with
+	the same objects, of any demonstration, replay the edges instead of checking and executing the
+	actions again and only have to evaluate the distances of the successors.
+	Unlike SearchGraph, the vertices have no extStateNum and no network output, one vertex stands for
+	the state paired with every observed state.
+*/
+class TransitionGraph
+{
+public:
+	struct Edge
+	{
+		int action;			// index of the primitive action
+		int next;			// id of the state it leads to
+	};
+
+	struct Vertex
+	{
+		SharedState state;			// shared with the successors given for it
+		bool expanded;
+		vector<Edge> edges;		// valid when expanded, in the order InternalState::genSuccessors gives them
+	};
+
+private:
+	vector<Object> intObjects;
+
+	// the actions grounded with the internal objects
+	ActionTable actionTable;
+
+	deque<Vertex> vertices;				// the id of a state is its index, deque keeps the references valid when it grows
+	unordered_multimap<size_t, int> index;
+
+	// the edges of a state, generated the first time
+	const vector<Edge>& edges(int id);
+
+public:
+	TransitionGraph(const vector<Object>& intObjectsVal, const vector<Action>& actions);
+	~TransitionGraph(void);
+
+	// check whether this instance is the graph of the given internal objects
+	bool matches(const vector<Object>& intObjectsVal) const;
+
+	// the id of a state, added when it is new
+	int id(const SharedState& s);
+
+	// the state of an id
+	const State& state(int id) const;
+
+	// successors of an internal state, as InternalState::genSuccessors would give them
+	void successors(const InternalState& s, list<InternalState>& successors);
+
+	// number of states
+	size_t size() const;
+};
+
+#endif
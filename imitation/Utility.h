@@ -3,9 +3,12 @@
 
 #include <sstream>
 #include <vector>
+#include <map>
 #include <functional>
 #include <cstdlib>
 
+#include "Symbol.h"
+
 using namespace std;
 
 /*
@@ -74,12 +77,47 @@ void shuffle(vector<in_type1> &in_value1, vector<in_type2> &in_value2)
     }
 };
 
+/*
+	Function: mixHash
+	Desc.	: scramble the bits of a hash value (64-bit finalizer of SplitMix)
+	Para.	: h, hash value
+	Return	: the scrambled value
+	Note	: used when hash values are combined by addition, so that similar values don't cancel out
+*/
+inline size_t mixHash(unsigned long long h)
+{
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebULL;
+	h ^= h >> 31;
+
+	return (size_t)h;
+};
+
+/*
+	Function: mapto
+	Desc.	: look up a key without adding it to the map
+	Para.	: key, the key
+			  m, the map
+	Return	: the value of the key, V() when the key isn't in the map
+	Note	: the same as m[key] for a key which is there, but doesn't change the map, so the maps
+			  can be shared by the training threads
+*/
+template <class K, class V>
+V mapto(const K& key, const map<K, V>& m)
+{
+	typename map<K, V>::const_iterator p = m.find(key);
+
+	return p == m.end() ? V() : p->second;
+};
+
 template <class T> 
 class sameName : public unary_function <T, bool>
 {
-	string s;
+	Symbol s;
 public:
-	explicit sameName(const string& val) : s(val) {}
+	explicit sameName(const Symbol& val) : s(val) {}
 	bool operator() (const T& o) const { return o.name == s; }
 };
 
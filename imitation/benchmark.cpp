@@ -0,0 +1,292 @@
+#include "Imitation.h"
+
+#include <cmath>
+
+using namespace std;
+
+/*
+	Checks the feature encoders of the searches against the conversion the program used before them,
+	and the ways the network is evaluated against the full evaluation, on the states of the
+	demonstrations, and times each of them. Built by the imitation_benchmark target of the Makefile,
+	it runs in the directory of the program's files like imitation.
+*/
+class EncoderBenchmark
+{
+	Imitation& im;
+
+	// the numeric representation of one state without the encoders
+	void convert(const State& state, bool internal, vector<double>& result);
+
+public:
+	EncoderBenchmark(Imitation& imVal) : im(imVal) {}
+
+	// check and time the encoders and the network on the demonstrations of a file
+	void run(string fileName);
+};
+
+/*
+	Function: convert()
+	Desc	: Given a state and return its numeric representation which encoding both relationship and objects' attributes
+	Para	: state, a state representation
+			  internal, whether the state is internal represetnation or not
+			  result, the numeric representation is appended to it
+	Return	: None
+	Note	: the searches use the FeatureEncoders of the context, which give the same numbers, this is
+			  the reference they are checked and timed against
+*/
+void EncoderBenchmark::convert(const State& state, bool internal, vector<double>& result)
+{
+	size_t i;
+	State::const_iterator iter;
+	
+	// internal or observed representation, referred to, not copied
+	const Symbol actor = internal ? mapto(Symbol(DEMO), im.mMap) : Symbol(DEMO);			// TEST ON 12/22/05
+	const vector<Object>& o = internal ? im.ctx.intObjects : im.ctx.currObservedObjects;		// objects
+	const map<Symbol,double>& m = internal ? im.intNumMap : im.extNumMap;					// map between symbol representation and numeric representation
+	
+	// assume each demonstration has a fully object definition, even if in some case just use part of it.
+	// Object name isn't encoded in the input, but its attributes, color and texture
+	for (i=0; i<o.size(); ++i)
+	{
+		// check if the same entry with "Demo objA" exists in the observed/internal state
+		iter = state.findPattern(Relation(SYM_WILDCARD, actor, o[i].name));
+		if (iter == state.end())
+			// not exists in the state, insert four 0 (relation, Demo and two attributes)
+			result.insert(result.end(),4, 0);
+		else
+		{
+			// relation
+			result.push_back(mapto(iter->relation, m));
+			// demonstrator or imitator
+			result.push_back(mapto(iter->objA, m));
+
+			// object attributes
+			result.push_back(mapto(o[i].color, m));
+			result.push_back(mapto(o[i].texture, m));
+		}
+	}
+
+	 // There is special case for gripper, check if an object on the gripper
+	iter = state.findPattern(Relation(SYM_ON, SYM_GRIPPER, SYM_WILDCARD));
+	result.push_back(mapto(SYM_ON, m));
+	result.push_back(mapto(SYM_GRIPPER, m));
+	
+	if (iter->objB == SYM_NULL)
+		// nothing on gripper, two 0s for attribute
+		result.insert(result.end(),2, 0);		// NULL or 0??
+	else
+	{
+		// find the object attributes
+		vector<Object>::const_iterator objIter = find_if(o.begin(), o.end(), sameName<Object>(iter->objB));
+		result.push_back(mapto(objIter->color, m));
+		result.push_back(mapto(objIter->texture, m));
+	}
+}
+
+/*
+	Function: run()
+	Desc.	: check that the feature encoders give the numbers of convert() and time both
+	Para.	: fileName, the demonstrations whose states are encoded
+	Return	: None
+	Note	: each observed state is paired with its internal state and the successors of it, the way the
+			  searches pair them. The time of each path is the best of several runs over all the pairs.
+			  When the network exists the inputs of the pairs are evaluated in full, from the hidden units'
+			  input of their parent and from the embedding table
+*/
+void EncoderBenchmark::run(string fileName)
+{
+	const int RUNS = 5, REPS = 200;
+	size_t i, j, k, n, parent;
+	int run, rep, mismatches = 0;
+	long pairs = 0;
+	double referenceTime = 0, encoderTime = 0, t, best[3], checksum = 0;
+	double networkTime[3] = {0, 0, 0}, largest[2] = {0, 0}, output;
+	vector<double> reference, features, inputs;
+	vector<int> changes;
+	vector<size_t> changeStarts;
+	vector<vector<size_t> > parents;					// index of the parent of each pair, the demo state's own index for it
+	FeedForward::Activation activation;
+	fstream fin;
+	list<InternalState> successors;
+	list<InternalState>::iterator iter;
+	vector<vector<pair<int, State> > > problems;		// observed state and internal state of the pairs of each demo
+	chrono::steady_clock::time_point start;
+
+	im.loadNewDemos(fileName);
+
+	for (i=0; i<im.newDemos.size(); ++i)
+	{
+		im.setCurrentObservedModel(im.ctx, im.newDemos[i].objects, im.newDemos[i].states);
+		ActionTable table(im.actions, im.ctx.intObjects);
+
+		problems.push_back(vector<pair<int, State> >());
+		parents.push_back(vector<size_t>());
+		for (j=0; j<im.newDemos[i].states.size(); ++j)
+		{
+			InternalState s(-1, mapping(im.newDemos[i].states[j], im.mMap), (int)j);
+			s.state.edit().updateNextTo();
+
+			parent = problems.back().size();
+			problems.back().push_back(make_pair((int)j, *s.state));
+			parents.back().push_back(parent);
+			successors = s.genSuccessors(table);
+			for (iter = successors.begin(); iter != successors.end(); ++iter)
+			{
+				problems.back().push_back(make_pair((int)j, *iter->state));
+				parents.back().push_back(parent);
+			}
+		}
+		pairs += problems.back().size();
+	}
+
+	// both paths must give the same numbers
+	for (i=0; i<problems.size(); ++i)
+	{
+		im.setCurrentObservedModel(im.ctx, im.newDemos[i].objects, im.newDemos[i].states);
+		for (j=0; j<problems[i].size(); ++j)
+		{
+			reference.clear();
+			convert(im.ctx.currObservedStates[problems[i][j].first], false, reference);
+			convert(problems[i][j].second, true, reference);
+
+			if (im.convert(im.ctx, im.ctx.currObservedStates[problems[i][j].first], problems[i][j].second) != reference)
+				++mismatches;
+		}
+	}
+
+	for (run=0; run<RUNS; ++run)
+	{
+		for (int encoder=0; encoder<2; ++encoder)
+		{
+			t = 0;
+			for (i=0; i<problems.size(); ++i)
+			{
+				im.setCurrentObservedModel(im.ctx, im.newDemos[i].objects, im.newDemos[i].states);
+				features.resize(im.numOfFeatures(im.ctx));
+
+				start = chrono::steady_clock::now();
+				for (rep=0; rep<REPS; ++rep)
+				{
+					for (j=0; j<problems[i].size(); ++j)
+					{
+						if (encoder == 0)
+						{
+							reference.clear();
+							convert(im.ctx.currObservedStates[problems[i][j].first], false, reference);
+							convert(problems[i][j].second, true, reference);
+							checksum += reference[0];
+						}
+						else
+						{
+							im.convert(im.ctx, im.ctx.currObservedStates[problems[i][j].first], problems[i][j].second, &features[0]);
+							checksum += features[0];
+						}
+					}
+				}
+				t += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			}
+
+			if (encoder == 0 && (run == 0 || t < referenceTime))
+				referenceTime = t;
+			if (encoder == 1 && (run == 0 || t < encoderTime))
+				encoderTime = t;
+		}
+	}
+
+	// the network from the parents' activation and from the embedding table must give the outputs of the full 
+	// evaluation up to rounding
+	fin.open(NNFILE.c_str());
+	if (fin.is_open())
+	{
+		im.nn.create(NNFILE);
+		for (i=0; i<problems.size(); ++i)
+		{
+			im.setCurrentObservedModel(im.ctx, im.newDemos[i].objects, im.newDemos[i].states);
+			n = im.numOfFeatures(im.ctx);
+			im.ctx.embeddings.check(im.nn, im.ctx.extEncoder, im.ctx.intEncoder);
+			inputs.resize(n * problems[i].size());
+			changes.clear();
+			changeStarts.assign(1, 0);
+
+			// a parent comes before its successors
+			for (j=0; j<problems[i].size(); ++j)
+			{
+				parent = parents[i][j];
+				im.convert(im.ctx, im.ctx.currObservedStates[problems[i][j].first], problems[i][j].second, &inputs[j*n]);
+				for (k=0; k<n; ++k)
+					if (inputs[j*n+k] != inputs[parent*n+k])
+						changes.push_back((int)k);
+				changeStarts.push_back(changes.size());
+
+				if (parent == j)
+					im.nn.activate(&inputs[j*n], activation);
+				im.nn.evaluate(&inputs[j*n], 1, &output);
+				largest[0] = max(largest[0], fabs(output - im.nn.evaluate(activation, &inputs[j*n], changes.data() + changeStarts[j], 
+					(int)(changeStarts[j+1] - changeStarts[j]))));
+				largest[1] = max(largest[1], fabs(output - im.ctx.embeddings.evaluate(im.ctx.currObservedStates[problems[i][j].first], 
+					problems[i][j].second)));
+			}
+
+			for (run=0; run<RUNS; ++run)
+			{
+				for (int derived=0; derived<3; ++derived)
+				{
+					start = chrono::steady_clock::now();
+					for (rep=0; rep<REPS; ++rep)
+					{
+						for (j=0; j<problems[i].size(); ++j)
+						{
+							if (derived == 0)
+								im.nn.evaluate(&inputs[j*n], 1, &output);
+							else if (derived == 2)
+								output = im.ctx.embeddings.evaluate(im.ctx.currObservedStates[problems[i][j].first], problems[i][j].second);
+							else if (parents[i][j] == j)
+								im.nn.activate(&inputs[j*n], activation);
+							else
+								output = im.nn.evaluate(activation, &inputs[j*n], changes.data() + changeStarts[j], 
+									(int)(changeStarts[j+1] - changeStarts[j]));
+							checksum += output;
+						}
+					}
+					t = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+					if (run == 0 || t < best[derived])
+						best[derived] = t;
+				}
+			}
+			networkTime[0] += best[0];
+			networkTime[1] += best[1];
+			networkTime[2] += best[2];
+		}
+	}
+	fin.close();
+
+	cout << "state pairs: " << pairs << " mismatches: " << mismatches << endl;
+	cout << "convert: " << referenceTime*1e9/(pairs*REPS) << " ns per pair" << endl;
+	cout << "encoder: " << encoderTime*1e9/(pairs*REPS) << " ns per pair" << endl;
+	cout << "speedup: " << referenceTime/encoderTime << endl;
+	if (networkTime[0] > 0)
+	{
+		cout << "network evaluated in full: " << networkTime[0]*1e9/(pairs*REPS) << " ns per input" << endl;
+		cout << "from the parent's activation: " << networkTime[1]*1e9/(pairs*REPS) << " ns per input, largest difference " << 
+			largest[0] << endl;
+		cout << "from the embedding table, states indexed: " << networkTime[2]*1e9/(pairs*REPS) << " ns per pair, largest difference " << 
+			largest[1] << endl;
+	}
+	cout << "(checksum " << checksum << ")" << endl;
+}
+
+int main(int argc, const char* argv[])
+{
+	if (argc > 2)
+	{
+		cout << "Usage: imitation_benchmark [demonstrations]\n" <<
+			"[demonstrations]: default is observedModel.txt, the network is read from " << NNFILE << " when it exists" << endl;
+		return -1;
+	}
+
+	Imitation intModel(10, false);
+	EncoderBenchmark(intModel).run(argc == 2 ? argv[1] : "observedModel.txt");
+
+	return 0;
+}
@@ -0,0 +1,235 @@
+#include "Imitation.h"
+
+using namespace std;
+
+/*
+	Checks the effects of the actions read from actions.txt against the effects which were coded by
+	action number before them, on the internal states a few actions away from the states of the
+	demonstrations. PUSH had number 3 and isn't in actions.txt, it is checked with the effects it
+	would have. Built by the imitation_check target of the Makefile, it runs in the directory of the
+	program's files like imitation and returns 1 when a successor differs.
+*/
+class EffectCheck
+{
+	Imitation& im;
+
+	// the next state of the effects coded by action number, p1 and p2 are the parameters of the action
+	State execute(const Action& a, Symbol p1, Symbol p2, const State& currState);
+
+	// whether two states have the same relations in the same order and the same nextTo objects
+	static bool same(const State& s1, const State& s2);
+
+public:
+	EffectCheck(Imitation& imVal) : im(imVal) {}
+
+	// check the actions on the demonstrations of a file, return the number of successors which differ
+	int run(string fileName, int depth);
+};
+
+/*
+	Function: execute()
+	Desc.	: Given a state, execute an action the way it was before the effects were read from actions.txt
+	Para.	: a, the action, parameterized with p1 and p2
+			  p1, parameter 1
+			  p2, parameter 2
+			  currState, current state
+	Return	: next state after executing the action
+*/
+State EffectCheck::execute(const Action& a, Symbol p1, Symbol p2, const State& currState)
+{
+	int i;
+	State nextState;
+
+	State::const_iterator q;
+
+	nextState = currState;
+	nextState.remove(a.preConds);
+
+	switch (a.num) {
+		case 0:		// MOVE
+		case 3:		// PUSH
+			for (i=0;i<nextState.size();++i)
+				if (nextState[i].relation==SYM_NEXT)
+					nextState.replace(i, Relation(SYM_AWAY, nextState[i].objA, nextState[i].objB));
+
+			if (nextState.nextTo.contains(p1))
+			{
+				for (i=nextState.nextTo.next(-1); i!=-1; i=nextState.nextTo.next(i))
+				{
+					q = find(nextState.begin(), nextState.end(), Relation(SYM_AWAY, SYM_IMITATOR, Symbol::at(i)));
+					if (q!=nextState.end())
+						nextState.replace(q-nextState.begin(), Relation(SYM_NEXT, q->objA, q->objB));
+				}
+			}
+
+			if (a.num==3)
+			{
+				nextState.nextTo.remove(p2);
+				if (nextState.nextTo.size()<2)
+					nextState.nextTo.clear();
+
+				nextState.nextTo.add(p2);
+				if (nextState.nextTo.contains(p1))
+					nextState.nextTo.add(p1);
+			}
+			break;
+		case 1:		// GRAB
+			nextState.nextTo.remove(p1);
+			if (nextState.nextTo.size()<2)
+				nextState.nextTo.clear();
+			break;
+		case 2:		// DROP
+			Relation r(SYM_NEXT, SYM_IMITATOR, SYM_WILDCARD);
+			State::const_iterator p = find(nextState.begin(), nextState.end(), r);
+			if (p!=nextState.end())
+			{
+				if (nextState.nextTo.empty())
+					nextState.nextTo.add(p->objB);
+				nextState.nextTo.add(p1);
+			}
+
+			r = Relation(SYM_NEXT, SYM_IMITATOR, SYM_TRASHCAN);
+			p=find(nextState.begin(), nextState.end(), r);
+			if (p==nextState.end())
+				nextState.add(Relation(SYM_NEXT,SYM_IMITATOR,a.preConds[0].objB));
+			break;
+	}
+
+	nextState.add(a.postConds);
+
+	return nextState;
+}
+
+/*
+	Function: same()
+	Desc.	: check whether two states are the same, including the order of the relations and nextTo
+	Para.	: s1, s2, the states
+	Return	: true when they are
+*/
+bool EffectCheck::same(const State& s1, const State& s2)
+{
+	return (s1.toString() == s2.toString() && s1.nextToObjects() == s2.nextToObjects());
+}
+
+/*
+	Function: run()
+	Desc.	: check the successors of the actions read from actions.txt against the ones of execute()
+	Para.	: fileName, the demonstrations whose states the actions start from
+			  depth, the number of actions taken from each state of the demonstrations
+	Return	: the number of successors which differ
+	Note	: PUSH is a copy of MOVE with number 3 and the effects "AWAY", "CARRY PARA_1", "LEAVE PARA_2",
+			  "JOIN PARA_2" and "REPEAT PARA_1", grounded with every two different internal objects
+*/
+int EffectCheck::run(string fileName, int depth)
+{
+	size_t i, j, k, l, m;
+	int level, mismatches = 0, pushes = 0;
+	long successors = 0;
+	vector<State> states, next;
+	vector<pair<Action, pair<Symbol, Symbol> > > grounded;		// action and its parameters
+	Action push;
+
+	im.loadNewDemos(fileName);
+
+	for (i=0; i<im.actions.size(); ++i)
+	{
+		if (im.actions[i].num == 3)
+			++pushes;
+		if (im.actions[i].num == 0)
+		{
+			push = im.actions[i];
+			push.num = 3;
+			push.name = "PUSH";
+			push.domains.clear();
+			push.effects.clear();
+			push.addEffect("AWAY", 0);
+			push.addEffect("CARRY", 0);
+			push.addEffect("LEAVE", 1);
+			push.addEffect("JOIN", 1);
+			push.addEffect("REPEAT", 0);
+		}
+	}
+
+	for (i=0; i<im.newDemos.size(); ++i)
+	{
+		im.setCurrentObservedModel(im.ctx, im.newDemos[i].objects, im.newDemos[i].states);
+		const vector<Object>& o = im.ctx.intObjects;
+
+		// ground the actions with their parameters, like ActionTable
+		grounded.clear();
+		for (j=0; j<im.actions.size(); ++j)
+		{
+			const int n = im.actions[j].arity();
+
+			if (n == 0)
+				grounded.push_back(make_pair(im.actions[j], make_pair(Symbol(), Symbol())));
+
+			for (k=0; n>0 && k<o.size(); ++k)
+			{
+				if (!im.actions[j].allows(0, o[k].name))
+					continue;
+
+				if (n == 1)
+					grounded.push_back(make_pair(im.actions[j], make_pair(o[k].name, Symbol())));
+
+				for (l=0; n==2 && l<o.size(); ++l)
+					if (k != l && im.actions[j].allows(1, o[l].name))
+						grounded.push_back(make_pair(im.actions[j], make_pair(o[k].name, o[l].name)));
+			}
+		}
+		for (k=0; k<o.size(); ++k)
+			for (l=0; l<o.size(); ++l)
+				if (k != l)
+					grounded.push_back(make_pair(push, make_pair(o[k].name, o[l].name)));
+		for (j=0; j<grounded.size(); ++j)
+			grounded[j].first.parameterize(grounded[j].second.first, grounded[j].second.second);
+
+		states.clear();
+		for (j=0; j<im.newDemos[i].states.size(); ++j)
+		{
+			states.push_back(mapping(im.newDemos[i].states[j], im.mMap));
+			states.back().updateNextTo();
+		}
+
+		for (level=0; level<depth; ++level)
+		{
+			next.clear();
+			for (j=0; j<states.size(); ++j)
+				for (m=0; m<grounded.size(); ++m)
+				{
+					const Action& a = grounded[m].first;
+					if (!a.IsSatisfied(states[j]))
+						continue;
+
+					State s = a.Execute(states[j]);
+					++successors;
+					if (!same(s, execute(a, grounded[m].second.first, grounded[m].second.second, states[j])))
+					{
+						++mismatches;
+						cout << a.name << " differs on\n" << states[j].toString() << states[j].nextToObjects() << endl;
+					}
+
+					// PUSH only checks, the actions of actions.txt lead on
+					if (a.num != 3)
+						next.push_back(move(s));
+				}
+			states.swap(next);
+		}
+	}
+
+	cout << "actions numbered 3 (PUSH) in actions.txt: " << pushes << endl;
+	cout << "successors checked: " << successors << endl;
+	cout << "successors which differ: " << mismatches << endl;
+
+	return mismatches;
+}
+
+int main(int argc, const char* argv[])
+{
+	Imitation intModel(10, false);
+
+	if (EffectCheck(intModel).run(argc >= 2 ? argv[1] : "observedModel.txt", argc == 3 ? atoi(argv[2]) : 3) != 0)
+		return 1;
+
+	return 0;
+}
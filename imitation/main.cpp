@@ -6,17 +6,63 @@ int main(int argc, const char* argv[])
 {
 	bool debugMode = false;
 	int numOfHiddenUnits = 10;
+	int searchType = Imitation::ASTAR;
+	int beamWidth = DEFAULT_BEAM_WIDTH;
+	double timeBudget = DEFAULT_TIME_BUDGET;
+	int numOfThreads = 0;
+	unsigned long long seed = (unsigned long long)time(0);
+	bool parentEvaluation = false;
+	bool tableEvaluation = false;
 	
 	if (argc < 2 || (argv[1] != string("L") && argv[1] != string("T")))
 	{
-		cout << "Usage: imitation type [numOfHiddenUnits] [debug?]\n" <<
+		cout << "Usage: imitation type [numOfHiddenUnits] [debug?] [search] [threads] [seed] [evaluation]\n" <<
 			"type: L, learning; T, testing\n" <<
-			"[numOfHiddenUnits]: default is 15\n[debug?]: default is 0" << endl;
+			"[numOfHiddenUnits]: default is 15\n[debug?]: default is 0\n" <<
+			"[search]: A, A* search; R, A* search reusing the graph of earlier searches;\n" <<
+			"          B[width], beam search keeping width nodes on each level (default width " << DEFAULT_BEAM_WIDTH << ");\n" <<
+			"          D[seconds], anytime search within a time budget (default " << DEFAULT_TIME_BUDGET << "s);\n" <<
+			"          I, iterative deepening A* search; L, layered search of the cheapest policy. default is A\n" <<
+			"[threads]: number of training threads, default is the number of cores\n" <<
+			"[seed]: seed of the training, default is the time\n" <<
+			"[evaluation]: P, successors evaluated from the hidden units' input of their parent;\n" <<
+			"              T, states evaluated from an embedding table of the slot values; PT, both;\n" <<
+			"              default is the full evaluation of every state" << endl;
 		return -1;
 	}
 
 	switch (argc)
 	{
+		case 8:
+			parentEvaluation = (string(argv[7]).find('P') != string::npos);
+			tableEvaluation = (string(argv[7]).find('T') != string::npos);
+			// fall through
+		case 7:
+			seed = strtoull(argv[6], 0, 10);
+			// fall through
+		case 6:
+			numOfThreads = atoi(argv[5]);
+			// fall through
+		case 5:
+			if (argv[4] == string("R"))
+				searchType = Imitation::REPLAN;
+			else if (argv[4] == string("I"))
+				searchType = Imitation::IDASTAR;
+			else if (argv[4] == string("L"))
+				searchType = Imitation::LAYERED;
+			else if (argv[4][0] == 'B')
+			{
+				searchType = Imitation::BEAM;
+				if (argv[4][1] != 0)
+					beamWidth = atoi(argv[4]+1);
+			}
+			else if (argv[4][0] == 'D')
+			{
+				searchType = Imitation::ANYTIME;
+				if (argv[4][1] != 0)
+					timeBudget = atof(argv[4]+1);
+			}
+			// fall through
 		case 4:
 			numOfHiddenUnits = atoi(argv[2]);
 			debugMode = (atoi(argv[3])==1);
@@ -27,6 +73,11 @@ int main(int argc, const char* argv[])
 	}
 
 	Imitation intModel(numOfHiddenUnits, debugMode);
+	intModel.setSearch(searchType, beamWidth);
+	intModel.setTimeBudget(timeBudget);
+	intModel.setParentEvaluation(parentEvaluation);
+	intModel.setTableEvaluation(tableEvaluation);
+	intModel.setParallel(numOfThreads > 0 ? numOfThreads : (int)thread::hardware_concurrency(), seed);
 	if (argv[1] == string("L"))
 		intModel.learning("observedModel.txt");
 	else
@@ -113,12 +113,17 @@ class tree {
       class sibling_iterator;
 
       tree();
+      /// Empty tree whose nodes come from the given allocator.
+      explicit tree(const tree_node_allocator&);
       tree(const T&);
       tree(const iterator_base&);
       tree(const tree<T, tree_node_allocator>&);
       ~tree();
       void operator=(const tree<T, tree_node_allocator>&);
 
+      /// The allocator of the nodes.
+      const tree_node_allocator& get_allocator() const { return alloc_; }
+
       /// Base class for iterators, only pointers stored, no traversal logic.
 #ifdef __SGI_STL_PORT
       class iterator_base : public stlport::bidirectional_iterator<T, ptrdiff_t> {
@@ -279,6 +284,8 @@ class tree {
       template<typename iter> iter append_child(iter position); 
       /// Insert node as last child of node pointed to by position.
       template<typename iter> iter append_child(iter position, const T& x);
+      /// Insert node as last child of node pointed to by position, moving the data into it.
+      template<typename iter> iter append_child(iter position, T&& x);
       /// Append the node (plus its children) at other_position as a child of position.
       template<typename iter> iter append_child(iter position, iter other_position);
       /// Append the nodes in the from-to range (plus their children) as children of position.
@@ -429,6 +436,13 @@ tree<T, tree_node_allocator>::tree()
    head_initialise_();
    }
 
+template <class T, class tree_node_allocator>
+tree<T, tree_node_allocator>::tree(const tree_node_allocator& alloc) 
+   : alloc_(alloc)
+   {
+   head_initialise_();
+   }
+
 template <class T, class tree_node_allocator>
 tree<T, tree_node_allocator>::tree(const T& x) 
    {
@@ -757,6 +771,30 @@ iter tree<T, tree_node_allocator>::append_child(iter position, const T& x)
    return tmp;
    }
 
+template <class T, class tree_node_allocator>
+template <class iter>
+iter tree<T, tree_node_allocator>::append_child(iter position, T&& x)
+   {
+   assert(position.node!=head);
+
+   tree_node* tmp = alloc_.allocate(1,0);
+   new ((void *) &tmp->data) T(std::move(x));
+   tmp->first_child=0;
+   tmp->last_child=0;
+
+   tmp->parent=position.node;
+   if(position.node->last_child!=0) {
+      position.node->last_child->next_sibling=tmp;
+      }
+   else {
+      position.node->first_child=tmp;
+      }
+   tmp->prev_sibling=position.node->last_child;
+   position.node->last_child=tmp;
+   tmp->next_sibling=0;
+   return tmp;
+   }
+
 template <class T, class tree_node_allocator>
 template <class iter>
 iter tree<T, tree_node_allocator>::append_child(iter position, iter other)